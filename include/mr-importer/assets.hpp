@@ -114,6 +114,125 @@ inline namespace importer {
     std::vector<Cone> cones;
   };
 
+  /**
+   * \brief Affine transform stored as the top three rows of a \ref Transform (48 bytes).
+   *
+   * Same row-major 3x4 layout as VkTransformMatrixKHR; the implicit last row is (0, 0, 0, 1).
+   */
+  struct AffineTransform {
+    std::array<std::array<float, 4>, 3> rows {};
+
+    AffineTransform() = default;
+    AffineTransform(const Transform &transform) noexcept;
+
+    /** \brief Expand back to a full 4x4 matrix. */
+    Transform matrix() const noexcept;
+  };
+
+  /**
+   * \brief Read-only instance transforms, shared between meshes.
+   *
+   * Every primitive of a glTF mesh references the same table, so instancing nodes with
+   * many transforms are stored once instead of once per primitive. Transforms are kept
+   * as 3x4 \ref AffineTransform and expanded on access. Copying the array copies the
+   * reference; assigning a new vector gives the mesh its own table.
+   */
+  class TransformArray {
+  public:
+    using Table = std::vector<AffineTransform>;
+
+    TransformArray() = default;
+    TransformArray(Table transforms)
+      : _table(std::make_shared<const Table>(std::move(transforms))) {}
+    TransformArray(std::initializer_list<Transform> transforms)
+      : TransformArray(Table(transforms.begin(), transforms.end())) {}
+    TransformArray(const std::vector<Transform> &transforms)
+      : TransformArray(Table(transforms.begin(), transforms.end())) {}
+    TransformArray(std::shared_ptr<const Table> table) : _table(std::move(table)) {}
+
+    std::size_t size() const noexcept { return _table ? _table->size() : 0; }
+    bool empty() const noexcept { return size() == 0; }
+    Transform operator[](std::size_t i) const noexcept { return (*_table)[i].matrix(); }
+
+    /** \brief Compact transforms, ready for upload as 3x4 instance matrices. */
+    std::span<const AffineTransform> affine() const noexcept {
+      if (!_table) {
+        return {};
+      }
+      return *_table;
+    }
+
+    /** \brief Shared table, null when there are no transforms. */
+    const std::shared_ptr<const Table> & table() const noexcept { return _table; }
+
+  private:
+    std::shared_ptr<const Table> _table;
+  };
+
+  /**
+   * \brief Animation sampled at fixed time codes (USD time-sampled points and xforms).
+   *
+   * Frame 0 is the mesh itself. Later frames store positions as 16-bit deltas against
+   * \ref Mesh::positions in steps of `delta_scale`, so every frame reuses the mesh topology,
+   * index buffers, LODs and vertex order.
+   */
+  struct MeshAnimation {
+    using QuantizedDelta = std::array<std::int16_t, 3>;
+
+    /** \brief Time code of every frame, frame 0 included. */
+    std::vector<double> times;
+    /** \brief Frame-major deltas of frames 1.., empty when positions are static. */
+    std::vector<QuantizedDelta> position_deltas;
+    PackedVec3f delta_scale {};
+    /** \brief Frame-major instance transforms of every frame, empty when they are static. */
+    std::vector<AffineTransform> transforms;
+
+    bool empty() const noexcept { return times.empty(); }
+    std::size_t frame_count() const noexcept { return times.size(); }
+
+    /** \brief Position of `vertex` at `frame`, `base` being \ref Mesh::positions. */
+    Position position(
+        const PositionArray &base, std::size_t frame, std::size_t vertex) const noexcept;
+  };
+
+  /**
+   * \brief Vertex data kept in its KHR_mesh_quantization storage.
+   *
+   * Filled instead of \ref Mesh::positions when \ref Options::KeepQuantizedVertices is set
+   * and the positions are 8- or 16-bit integers. Every such component is stored as a 16-bit
+   * `q` and reads back as `q * scale + offset`. Normals and texture coordinates stored as
+   * floats in the source stay in \ref Mesh::attributes, and their arrays here stay empty.
+   */
+  struct QuantizedVertexArray {
+    using Quantized3 = std::array<std::uint16_t, 3>;
+    using Quantized2 = std::array<std::uint16_t, 2>;
+
+    /** \brief Affine decode shared by every component of one attribute. */
+    struct Decode {
+      float scale = 1.f;
+      float offset = 0.f;
+
+      float operator()(std::uint16_t q) const noexcept { return q * scale + offset; }
+    };
+
+    std::vector<Quantized3> positions;
+    std::vector<Quantized3> normals;
+    std::vector<Quantized2> texcoords;
+    Decode position_decode;
+    Decode normal_decode;
+    Decode texcoord_decode;
+
+    bool empty() const noexcept { return positions.empty(); }
+
+    /** \brief Positions expanded to floats, in object space like \ref Mesh::positions. */
+    PositionArray dequantize_positions() const;
+    /**
+     * \brief Write the quantized normals and texture coordinates into `attributes`, which
+     * holds one element per vertex. Attributes not stored here are left untouched.
+     */
+    void dequantize_attributes(VertexAttributesArray &attributes) const;
+  };
+
   /** \brief Renderable mesh with positions, attributes and LODs. */
   struct Mesh {
     /** \brief One level-of-detail of mesh indices. */
@@ -124,11 +243,13 @@ inline namespace importer {
       MeshletBoundsArray meshlet_bounds;
     };
 
-    PositionArray positions;
+    PositionArray positions; // Empty when the positions are in `quantized`
     IndexArray indices;
     VertexAttributesArray attributes;
+    QuantizedVertexArray quantized;
     std::vector<LOD> lods;
-    std::vector<Transform> transforms;
+    TransformArray transforms;
+    MeshAnimation animation;
     std::string name;
     std::size_t material;
     BoundingSphere bounding_sphere;
@@ -180,10 +301,38 @@ inline namespace importer {
     };
   };
 
+  /**
+   * \brief Deleter of \ref SizedUniqueArray: `delete[]`, or the `free` of the backend that
+   * allocated the array when it was adopted without a copy (e.g. libktx's transcode output).
+   */
   template <typename T>
-  struct SizedUniqueArray : public std::unique_ptr<T[]> {
-    using std::unique_ptr<T[]>::unique_ptr;
-    using std::unique_ptr<T[]>::operator=;
+  struct ArrayDeleter {
+    void (*free)(void *) = nullptr;
+
+    constexpr ArrayDeleter() noexcept = default;
+    constexpr ArrayDeleter(void (*free_function)(void *)) noexcept : free(free_function) {}
+    constexpr ArrayDeleter(std::default_delete<T[]>) noexcept {}
+
+    void operator()(T *ptr) const noexcept {
+      if (free != nullptr) {
+        free(const_cast<std::remove_const_t<T> *>(ptr));
+      }
+      else {
+        delete[] ptr;
+      }
+    }
+  };
+
+  template <typename T>
+  struct SizedUniqueArray : public std::unique_ptr<T[], ArrayDeleter<T>> {
+    using std::unique_ptr<T[], ArrayDeleter<T>>::unique_ptr;
+    using std::unique_ptr<T[], ArrayDeleter<T>>::operator=;
+
+    /** \brief Free the current array with its deleter, then own `ptr`, allocated with `new[]`. */
+    void reset(T *ptr = nullptr) noexcept {
+      std::unique_ptr<T[], ArrayDeleter<T>>::reset(ptr);
+      this->get_deleter() = ArrayDeleter<T>();
+    }
 
   private:
     size_t _size = 0;
@@ -194,16 +343,29 @@ inline namespace importer {
   };
 
   // material-related data
+  /**
+   * \brief Large mips left in the source file by \ref Options::StreamTextureMips.
+   *
+   * Pass it to \ref load_deferred_mips to read them when they become visible.
+   */
+  struct DeferredMips {
+    std::filesystem::path path; // KTX2 or DDS file the mips are read from
+    uint32_t mip_count = 0;     // Number of leading (largest) mips that were not loaded
+  };
+
   /** \brief Raw image data stored as linear RGBA float pixels. */
   struct ImageData {
     // unique ptr because memory is allocated by the backend and passed to us
     SizedUniqueArray<std::byte> pixels;
+    // mips[0] is mip `first_mip()` of the full chain, see \ref deferred
     InplaceVector<std::span<const std::byte>, 16> mips;
+    // Width/height/depth of mip 0 even when it is deferred
     int32_t width = 0;
     int32_t height = 0;
     int32_t depth = 1;
     int32_t bytes_per_pixel = -1;
     vk::Format format {};
+    std::optional<DeferredMips> deferred;
 
     ImageData() = default;
     ~ImageData() noexcept = default;
@@ -215,6 +377,8 @@ inline namespace importer {
     uint32_t pixel_byte_size() const noexcept;
     constexpr uint32_t num_of_pixels() const noexcept { return width * height; }
     constexpr mr::Extent extent() const noexcept { return {uint32_t(width), uint32_t(height)}; }
+    /** \brief Index of the full-chain mip stored in mips[0]. */
+    uint32_t first_mip() const noexcept { return deferred.has_value() ? deferred->mip_count : 0; }
   };
 
   /** \brief Texture sampler settings placeholder. */
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <cstdint>
 
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
@@ -26,9 +26,20 @@ inline namespace importer {
    * USD (\c .usd, \c .usda, \c .usdc, \c .usdz) honors the same \c Options as glTF where
    * applicable: \c LoadMaterials, \c LoadMeshAttributes, image flags (\c PreferUncompressed,
    * \c Allow*ComponentImages) for textures, and post-load \c OptimizeMeshes, \c GenerateDiscreteLODs,
-   * \c GenerateMeshlets. OpenUSD plugins must be discoverable (see \c MR_IMPORTER_USD_PLUGIN_ROOT
-   * / \c PXR_PLUGINPATH) or \c .usdz and some references can fail to resolve.
+   * \c GenerateMeshlets, \c DeduplicateMeshes. OpenUSD plugins must be discoverable
+   * (see \c MR_IMPORTER_USD_PLUGIN_ROOT / \c PXR_PLUGINPATH) or \c .usdz and some
+   * references can fail to resolve.
    */
   std::optional<Model> import(const std::filesystem::path& path, Options options = Options::All);
+
+  /**
+   * \brief Same as \ref import, restricted to the part of a USD stage picked by \p usd_filter.
+   *
+   * Prims outside \ref UsdImportFilter::prim_paths are never composed, and with
+   * \ref UsdImportFilter::payload_paths set the stage is opened with payloads unloaded and
+   * only the listed ones are loaded, so importing one asset does not pay for the whole stage.
+   */
+  std::optional<Model> import(
+      const std::filesystem::path& path, Options options, const UsdImportFilter& usd_filter);
 } // namespace importer
 } // namespace mr
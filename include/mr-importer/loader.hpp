@@ -8,6 +8,8 @@
 #include "assets.hpp"
 #include "options.hpp"
 
+#include <future>
+
 namespace mr {
 inline namespace importer {
   /**
@@ -23,5 +25,17 @@ inline namespace importer {
    */
   std::optional<ImageData> load_image_from_file_path(
       const std::filesystem::path &path, Options options);
+
+  /**
+   * \brief Read `count` deferred mips starting at full-chain mip `first_mip`.
+   * Thread-safe. The result keeps the base width/height, its \ref ImageData::first_mip
+   * is `first_mip`.
+   */
+  std::optional<ImageData> load_deferred_mips(
+      const DeferredMips &deferred, uint32_t first_mip, uint32_t count);
+
+  /** \brief Same as \ref load_deferred_mips, run on a background thread. */
+  std::future<std::optional<ImageData>> load_deferred_mips_async(
+      DeferredMips deferred, uint32_t first_mip, uint32_t count);
 }
 } // namespace mr
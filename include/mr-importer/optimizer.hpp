@@ -18,5 +18,16 @@ inline namespace importer {
    * \return Optimized mesh with at least one LOD populated.
    */
   Mesh optimize(Mesh mesh);
+
+  /**
+   * \brief Merge meshes with identical geometry into instanced meshes.
+   *
+   * Meshes whose positions, indices, attributes and material match byte for byte become
+   * one mesh carrying all of their transforms, so later optimization runs once per
+   * unique mesh.
+   * \param meshes Input meshes.
+   * \return Unique meshes, in order of first occurrence.
+   */
+  std::vector<Mesh> deduplicate_meshes(std::vector<Mesh> meshes);
 }
 } // namespace mr
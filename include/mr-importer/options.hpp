@@ -6,6 +6,9 @@
  */
 
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace mr {
 inline namespace importer {
@@ -39,7 +42,29 @@ inline namespace importer {
     /** \brief Generate attributes */
     GenerateMeshAttributes = 1 << 10,
 
-    All = ~None,
+    /**
+     * \brief Load only the mip tail of KTX2/DDS texture files.
+     * Mips larger than 256px stay in the file and are described by ImageData::deferred.
+     * Opt-in (not part of \ref All): ImageData::mips no longer starts at the base level.
+     */
+    StreamTextureMips = 1 << 11,
+
+    /**
+     * \brief Merge meshes with identical geometry and material into one instanced mesh.
+     * Opt-in (not part of \ref All): changes mesh count and order, and merged meshes keep
+     * the name of the first one.
+     */
+    DeduplicateMeshes = 1 << 12,
+
+    /**
+     * \brief Keep KHR_mesh_quantization vertex data in its 8/16-bit storage.
+     * Opt-in (not part of \ref All): quantized meshes fill Mesh::quantized and leave
+     * Mesh::positions empty; see QuantizedVertexArray for decoding.
+     */
+    KeepQuantizedVertices = 1 << 13,
+
+    /** \brief Every option except the opt-in ones that change the shape of the result. */
+    All = ~None & ~StreamTextureMips & ~DeduplicateMeshes & ~KeepQuantizedVertices,
   };
 
   constexpr bool is_enabled(Options options, uint32_t option) noexcept {
@@ -51,6 +76,9 @@ inline namespace importer {
 
   static_assert(is_enabled(Options::None, Options::None));
   static_assert(is_disabled(Options::All, Options::None));
+  static_assert(is_disabled(Options::All, Options::StreamTextureMips));
+  static_assert(is_disabled(Options::All, Options::DeduplicateMeshes));
+  static_assert(is_disabled(Options::All, Options::KeepQuantizedVertices));
 
   constexpr Options & enable(Options &options, uint32_t option) noexcept {
     return options = Options(options | option);
@@ -58,5 +86,31 @@ inline namespace importer {
   constexpr Options & disable(Options &options, uint32_t option) noexcept {
     return options = Options(options & ~option);
   }
+
+  /** \brief USD time codes from `start` to `end` (both included) every `step`. */
+  struct UsdTimeRange {
+    double start = 0.0;
+    double end = 0.0;
+    double step = 1.0;
+  };
+
+  /**
+   * \brief Part of a USD stage to import, so one asset can be pulled out of a large set.
+   * Paths are absolute prim paths (e.g. \c /World/Props/Chair_01). Ignored for glTF.
+   */
+  struct UsdImportFilter {
+    /** \brief Prims composed with their descendants (population mask), empty for all. */
+    std::vector<std::string> prim_paths;
+    /**
+     * \brief Prims whose payloads are loaded with their descendants' payloads.
+     * When unset every payload on the stage is loaded; an empty list loads none.
+     */
+    std::optional<std::vector<std::string>> payload_paths;
+    /**
+     * \brief Frames at which time-varying points and xforms are sampled into
+     * \ref Mesh::animation. When unset only default (static) values are read.
+     */
+    std::optional<UsdTimeRange> time_range;
+  };
 } // namespace importer
 } // namespace mr
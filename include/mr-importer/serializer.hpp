@@ -25,9 +25,11 @@ bool serialize(const Model &model, const std::string &filepath);
 /**
  * \brief Deserialize a Model from binary file.
  *
- * Loads a previously serialized Model from a binary file.
+ * Loads a previously serialized Model from a binary file. Archives carry a format
+ * version, and ones written with another version are rejected; re-import the source
+ * asset (and serialize it again) in that case.
  * \param filepath Path to the serialized data.
- * \return Deserialized model, or std::nullopt on failure.
+ * \return Deserialized model, or std::nullopt on failure or version mismatch.
  */
 std::optional<Model> deserialize(const std::string &filepath);
 
@@ -44,7 +46,8 @@ bool serialize(const Mesh &mesh, const std::string &filepath);
 /**
  * \brief Deserialize a Mesh from binary file.
  *
- * Loads a previously serialized Mesh from a binary file.
+ * Loads a previously serialized Mesh from a binary file, rejecting archives of
+ * another format version like \ref deserialize.
  * \param filepath Path to the serialized data.
  * \return Deserialized mesh, or std::nullopt on failure.
  */
@@ -63,7 +66,8 @@ bool serialize(const MaterialData &material, const std::string &filepath);
 /**
  * \brief Deserialize a MaterialData from binary file.
  *
- * Loads a previously serialized MaterialData from a binary file.
+ * Loads a previously serialized MaterialData from a binary file, rejecting archives of
+ * another format version like \ref deserialize.
  * \param filepath Path to the serialized data.
  * \return Deserialized material, or std::nullopt on failure.
  */
@@ -0,0 +1,484 @@
+/**
+ * \file accessors.cpp
+ * \brief Bulk glTF accessor to float/index array conversion.
+ */
+
+#include "accessors.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mr {
+inline namespace importer {
+namespace {
+/** Elements per task, large enough that scheduling is noise next to the conversion. */
+constexpr size_t accessor_grain = 1 << 14;
+
+/** glTF normalized integer -> float (KHR spec: c / max, clamped to -1 for signed types). */
+template <typename T>
+static float dequantize(T value, bool normalized) noexcept
+{
+  if constexpr (std::is_same_v<T, float>) {
+    return value;
+  }
+  else {
+    if (!normalized) {
+      return static_cast<float>(value);
+    }
+    const float result =
+        static_cast<float>(value) * (1.0f / static_cast<float>(std::numeric_limits<T>::max()));
+    return std::is_signed_v<T> ? std::max(result, -1.0f) : result;
+  }
+}
+
+/** Whether `T` components can be written as `Out`: floats take anything, uint16 takes 8/16-bit. */
+template <typename Out, typename T>
+constexpr bool storable_as =
+    std::is_same_v<Out, float> || (std::is_integral_v<T> && sizeof(T) <= sizeof(Out));
+
+/**
+ * One component as `Out`: floats are dequantized, uint16 keeps the quantized value with signed
+ * types re-biased to unsigned (see `quantized_decode`).
+ */
+template <typename Out, typename T>
+static Out store_component(T value, bool normalized) noexcept
+{
+  if constexpr (std::is_same_v<Out, float>) {
+    return dequantize(value, normalized);
+  }
+  else if constexpr (std::is_signed_v<T>) {
+    // Normalized -max-1 reads as -1 just like -max, fold it so one affine decode fits both
+    if (normalized) {
+      value = std::max<T>(value, -std::numeric_limits<T>::max());
+    }
+    return static_cast<Out>(static_cast<int32_t>(value) - std::numeric_limits<T>::min());
+  }
+  else {
+    return static_cast<Out>(value);
+  }
+}
+
+/** Convert one element at `src` into `N` components of type `Out` at `dst`. */
+template <typename T, uint32_t N, typename Out>
+static void convert_element(const std::byte *src, bool normalized, std::byte *dst) noexcept
+{
+  T values[N];
+  std::memcpy(values, src, sizeof(values));
+
+  Out result[N];
+  for (uint32_t c = 0; c < N; c++) {
+    result[c] = store_component<Out>(values[c], normalized);
+  }
+  std::memcpy(dst, result, sizeof(result));
+}
+
+/**
+ * Convert elements [begin, end) with the component type and count known at compile time,
+ * so the per-element work is a fixed-size loop the compiler unrolls and vectorizes.
+ */
+template <typename T, uint32_t N, typename Out>
+static void convert_range(const AccessorView &view,
+    std::byte *dst,
+    size_t dst_stride,
+    size_t begin,
+    size_t end)
+{
+  constexpr size_t dst_size = N * sizeof(Out);
+
+  // Tight data already in the destination type and layout is a plain copy
+  if constexpr (std::is_same_v<T, Out>) {
+    if (view.stride == dst_size && dst_stride == dst_size) {
+      std::memcpy(dst + begin * dst_size, view.data + begin * dst_size, (end - begin) * dst_size);
+      return;
+    }
+  }
+
+  for (size_t i = begin; i < end; i++) {
+    convert_element<T, N, Out>(
+        view.data + i * view.stride, view.normalized, dst + i * dst_stride);
+  }
+}
+
+/** Call `f(T{})` with `T` the C++ type of `component_type`, returns false if unsupported. */
+template <typename F>
+static bool dispatch_component_type(fastgltf::ComponentType component_type, F &&f)
+{
+  using fastgltf::ComponentType;
+
+  switch (component_type) {
+  case ComponentType::Float:
+    f(float());
+    return true;
+  case ComponentType::UnsignedByte:
+    f(uint8_t());
+    return true;
+  case ComponentType::Byte:
+    f(int8_t());
+    return true;
+  case ComponentType::UnsignedShort:
+    f(uint16_t());
+    return true;
+  case ComponentType::Short:
+    f(int16_t());
+    return true;
+  case ComponentType::UnsignedInt:
+    f(uint32_t());
+    return true;
+  default:
+    return false;
+  }
+}
+
+template <uint32_t N, typename Out>
+static bool convert_view(const AccessorView &view, std::byte *dst, size_t dst_stride)
+{
+  bool storable = true;
+  const bool supported = dispatch_component_type(view.component_type, [&]<typename T>(T) {
+    if constexpr (storable_as<Out, T>) {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, view.count, accessor_grain),
+          [&](const tbb::blocked_range<size_t> &range) {
+            convert_range<T, N, Out>(view, dst, dst_stride, range.begin(), range.end());
+          });
+    }
+    else {
+      storable = false;
+    }
+  });
+  return supported && storable;
+}
+
+/** Fill `count` elements with the value a zero component of `component_type` stores as. */
+template <uint32_t N, typename Out>
+static bool fill_zero(fastgltf::ComponentType component_type,
+    bool normalized,
+    size_t count,
+    std::byte *dst,
+    size_t dst_stride)
+{
+  bool storable = true;
+  const bool supported = dispatch_component_type(component_type, [&]<typename T>(T) {
+    if constexpr (storable_as<Out, T>) {
+      Out zero[N];
+      std::fill_n(zero, N, store_component<Out>(T(0), normalized));
+      for (size_t i = 0; i < count; i++) {
+        std::memcpy(dst + i * dst_stride, zero, sizeof(zero));
+      }
+    }
+    else {
+      storable = false;
+    }
+  });
+  return supported && storable;
+}
+
+/** Index `i` of an unsigned integer index view. */
+static size_t read_index(const AccessorView &view, size_t i) noexcept
+{
+  const std::byte *src = view.data + i * view.stride;
+  switch (view.component_type) {
+  case fastgltf::ComponentType::UnsignedByte:
+    return static_cast<size_t>(*reinterpret_cast<const uint8_t *>(src));
+  case fastgltf::ComponentType::UnsignedShort: {
+    uint16_t index;
+    std::memcpy(&index, src, sizeof(index));
+    return index;
+  }
+  default: {
+    uint32_t index;
+    std::memcpy(&index, src, sizeof(index));
+    return index;
+  }
+  }
+}
+
+/** Overwrite the elements listed by a sparse accessor in place. */
+template <uint32_t N, typename Out>
+static bool apply_sparse(const AccessorView &indices,
+    const AccessorView &values,
+    size_t element_count,
+    std::byte *dst,
+    size_t dst_stride)
+{
+  using fastgltf::ComponentType;
+
+  if (indices.component_type != ComponentType::UnsignedByte &&
+      indices.component_type != ComponentType::UnsignedShort &&
+      indices.component_type != ComponentType::UnsignedInt) {
+    return false;
+  }
+
+  bool in_range = true;
+  const bool supported = dispatch_component_type(values.component_type, [&]<typename T>(T) {
+    if constexpr (storable_as<Out, T>) {
+      for (size_t i = 0; i < indices.count; i++) {
+        const size_t index = read_index(indices, i);
+        if (index >= element_count) {
+          in_range = false;
+          return;
+        }
+        convert_element<T, N, Out>(
+            values.data + i * values.stride, values.normalized, dst + index * dst_stride);
+      }
+    }
+    else {
+      in_range = false;
+    }
+  });
+  return supported && in_range;
+}
+
+/** View `count` elements of `buffer_view_index` starting at `byte_offset`. */
+static std::optional<AccessorView> make_view(const fastgltf::Asset &asset,
+    size_t buffer_view_index,
+    size_t byte_offset,
+    size_t count,
+    fastgltf::AccessorType type,
+    fastgltf::ComponentType component_type,
+    bool normalized)
+{
+  if (buffer_view_index >= asset.bufferViews.size()) {
+    return std::nullopt;
+  }
+
+  const fastgltf::BufferView &buffer_view = asset.bufferViews[buffer_view_index];
+  const std::span<const std::byte> bytes = get_buffer_bytes(asset.buffers[buffer_view.bufferIndex]);
+
+  AccessorView view;
+  view.count = count;
+  view.component_type = component_type;
+  view.components = static_cast<uint32_t>(fastgltf::getNumComponents(type));
+  view.normalized = normalized;
+
+  const size_t element_size = fastgltf::getElementByteSize(type, component_type);
+  view.stride = buffer_view.byteStride.has_value() ? *buffer_view.byteStride : element_size;
+
+  const size_t offset = buffer_view.byteOffset + byte_offset;
+  const size_t extent = view.count == 0 ? 0 : (view.count - 1) * view.stride + element_size;
+  if (element_size == 0 || offset > bytes.size() || extent > bytes.size() - offset) {
+    return std::nullopt;
+  }
+
+  view.data = bytes.data() + offset;
+  return view;
+}
+
+template <uint32_t N, typename Out>
+static bool convert_accessor(const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    std::byte *dst,
+    size_t dst_stride)
+{
+  if (accessor.bufferViewIndex.has_value()) {
+    const std::optional<AccessorView> view = make_view(asset,
+        *accessor.bufferViewIndex,
+        accessor.byteOffset,
+        accessor.count,
+        accessor.type,
+        accessor.componentType,
+        accessor.normalized);
+    if (!view.has_value() || !convert_view<N, Out>(*view, dst, dst_stride)) {
+      return false;
+    }
+  }
+  else {
+    // No base data: the accessor is all zeros plus its sparse substitutions
+    if (!fill_zero<N, Out>(
+            accessor.componentType, accessor.normalized, accessor.count, dst, dst_stride)) {
+      return false;
+    }
+  }
+
+  if (!accessor.sparse.has_value()) {
+    return true;
+  }
+
+  const fastgltf::SparseAccessor &sparse = *accessor.sparse;
+  const std::optional<AccessorView> indices = make_view(asset,
+      sparse.indicesBufferView,
+      sparse.indicesByteOffset,
+      sparse.count,
+      fastgltf::AccessorType::Scalar,
+      sparse.indexComponentType,
+      false);
+  const std::optional<AccessorView> values = make_view(asset,
+      sparse.valuesBufferView,
+      sparse.valuesByteOffset,
+      sparse.count,
+      accessor.type,
+      accessor.componentType,
+      accessor.normalized);
+  if (!indices.has_value() || !values.has_value()) {
+    return false;
+  }
+
+  // Sparse buffer views are tightly packed by definition
+  AccessorView tight_indices = *indices;
+  tight_indices.stride = fastgltf::getElementByteSize(
+      fastgltf::AccessorType::Scalar, tight_indices.component_type);
+  AccessorView tight_values = *values;
+  tight_values.stride = fastgltf::getElementByteSize(accessor.type, accessor.componentType);
+
+  return apply_sparse<N, Out>(tight_indices, tight_values, accessor.count, dst, dst_stride);
+}
+
+/** `convert_accessor` with the component count picked at run time. */
+template <typename Out>
+static bool convert_accessor_components(const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    uint32_t components,
+    std::byte *dst,
+    size_t dst_stride)
+{
+  if (components > static_cast<uint32_t>(fastgltf::getNumComponents(accessor.type))) {
+    return false;
+  }
+
+  switch (components) {
+  case 1:
+    return convert_accessor<1, Out>(asset, accessor, dst, dst_stride);
+  case 2:
+    return convert_accessor<2, Out>(asset, accessor, dst, dst_stride);
+  case 3:
+    return convert_accessor<3, Out>(asset, accessor, dst, dst_stride);
+  case 4:
+    return convert_accessor<4, Out>(asset, accessor, dst, dst_stride);
+  default:
+    return false;
+  }
+}
+
+/** Decode of components kept as uint16 by `store_component`, if the type can be. */
+static std::optional<QuantizedVertexArray::Decode> quantized_decode(
+    fastgltf::ComponentType component_type, bool normalized)
+{
+  std::optional<QuantizedVertexArray::Decode> decode;
+  dispatch_component_type(component_type, [&]<typename T>(T) {
+    if constexpr (storable_as<uint16_t, T>) {
+      // store_component keeps q - min(T), so value = (stored + min(T)) * scale
+      const float scale =
+          normalized ? 1.0f / static_cast<float>(std::numeric_limits<T>::max()) : 1.0f;
+      const float bias = std::is_signed_v<T> ? static_cast<float>(std::numeric_limits<T>::min())
+                                             : 0.0f;
+      decode = QuantizedVertexArray::Decode {scale, bias * scale};
+    }
+  });
+  return decode;
+}
+
+template <typename T>
+static void widen_indices(const AccessorView &view, uint32_t *dst)
+{
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, view.count, accessor_grain),
+      [&](const tbb::blocked_range<size_t> &range) {
+        if (view.stride == sizeof(uint32_t) && std::is_same_v<T, uint32_t>) {
+          std::memcpy(dst + range.begin(),
+              view.data + range.begin() * sizeof(uint32_t),
+              range.size() * sizeof(uint32_t));
+          return;
+        }
+        for (size_t i = range.begin(); i < range.end(); i++) {
+          T index;
+          std::memcpy(&index, view.data + i * view.stride, sizeof(T));
+          dst[i] = index;
+        }
+      });
+}
+} // namespace
+
+std::span<const std::byte> get_buffer_bytes(const fastgltf::Buffer &buffer)
+{
+  return std::visit(fastgltf::visitor{[](const fastgltf::sources::Array &array) {
+                                        return std::span<const std::byte>(
+                                            array.bytes.data(), array.bytes.size());
+                                      },
+                        [](const fastgltf::sources::Vector &vector) {
+                          return std::span<const std::byte>(
+                              vector.bytes.data(), vector.bytes.size());
+                        },
+                        [](const fastgltf::sources::ByteView &view) {
+                          return std::span<const std::byte>(view.bytes.data(), view.bytes.size());
+                        },
+                        [](const auto &arg) {
+                          DEBUG_ASSERT(false, "Buffer is not resident in memory", arg);
+                          return std::span<const std::byte>();
+                        }},
+      buffer.data);
+}
+
+std::optional<AccessorView> get_accessor_view(
+    const fastgltf::Asset &asset, const fastgltf::Accessor &accessor)
+{
+  if (accessor.sparse.has_value() || !accessor.bufferViewIndex.has_value()) {
+    return std::nullopt;
+  }
+
+  return make_view(asset,
+      *accessor.bufferViewIndex,
+      accessor.byteOffset,
+      accessor.count,
+      accessor.type,
+      accessor.componentType,
+      accessor.normalized);
+}
+
+bool convert_accessor(const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    uint32_t components,
+    std::byte *dst,
+    size_t dst_stride)
+{
+  ZoneScoped;
+
+  return convert_accessor_components<float>(asset, accessor, components, dst, dst_stride);
+}
+
+bool is_quantized_component(fastgltf::ComponentType component_type)
+{
+  return quantized_decode(component_type, false).has_value();
+}
+
+std::optional<QuantizedVertexArray::Decode> copy_quantized_accessor(
+    const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    uint32_t components,
+    std::byte *dst,
+    size_t dst_stride)
+{
+  ZoneScoped;
+
+  const std::optional<QuantizedVertexArray::Decode> decode =
+      quantized_decode(accessor.componentType, accessor.normalized);
+  if (!decode.has_value() ||
+      !convert_accessor_components<uint16_t>(asset, accessor, components, dst, dst_stride)) {
+    return std::nullopt;
+  }
+  return decode;
+}
+
+bool convert_index_accessor(
+    const fastgltf::Asset &asset, const fastgltf::Accessor &accessor, uint32_t *dst)
+{
+  ZoneScoped;
+
+  const std::optional<AccessorView> view = get_accessor_view(asset, accessor);
+  if (!view.has_value()) {
+    fastgltf::copyFromAccessor<std::uint32_t>(asset, accessor, dst);
+    return true;
+  }
+
+  switch (view->component_type) {
+  case fastgltf::ComponentType::UnsignedByte:
+    widen_indices<uint8_t>(*view, dst);
+    return true;
+  case fastgltf::ComponentType::UnsignedShort:
+    widen_indices<uint16_t>(*view, dst);
+    return true;
+  case fastgltf::ComponentType::UnsignedInt:
+    widen_indices<uint32_t>(*view, dst);
+    return true;
+  default:
+    return false;
+  }
+}
+} // namespace importer
+} // namespace mr
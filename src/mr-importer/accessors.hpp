@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * \file accessors.hpp
+ * \brief Internal bulk conversion of glTF accessors into importer arrays.
+ */
+
+#include "mr-importer/assets.hpp"
+
+#include "pch.hpp"
+
+namespace mr {
+inline namespace importer {
+/** Resident, strided view of the elements of a non-sparse accessor. */
+struct AccessorView {
+  const std::byte *data = nullptr;
+  size_t stride = 0; // Bytes between consecutive elements
+  size_t count = 0;
+  fastgltf::ComponentType component_type = fastgltf::ComponentType::Float;
+  uint32_t components = 0;
+  bool normalized = false;
+};
+
+/** Bytes of a buffer that is resident in memory (owned by fastgltf or mapped). */
+std::span<const std::byte> get_buffer_bytes(const fastgltf::Buffer &buffer);
+
+/**
+ * Resolve `accessor` to its bytes in memory.
+ * Returns nothing for sparse or buffer-less accessors and for views that are out of range.
+ */
+std::optional<AccessorView> get_accessor_view(
+    const fastgltf::Asset &asset, const fastgltf::Accessor &accessor);
+
+/**
+ * Convert the first `components` components of every element of `accessor` to floats,
+ * element `i` is written at `dst + i * dst_stride`.
+ *
+ * Tight float data is copied in bulk, integer and normalized data (KHR_mesh_quantization)
+ * is dequantized straight into `dst` with fixed-width loops the compiler vectorizes, and
+ * large accessors are split across the TBB pool. Sparse substitutions are scattered over
+ * the converted base in place, without building a dense copy of the accessor.
+ * Returns false for unsupported component types and out-of-range data.
+ */
+bool convert_accessor(const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    uint32_t components,
+    std::byte *dst,
+    size_t dst_stride);
+
+/** 8- and 16-bit integer components, the ones `copy_quantized_accessor` keeps compact. */
+bool is_quantized_component(fastgltf::ComponentType component_type);
+
+/**
+ * Copy the first `components` components of every element of an 8- or 16-bit integer
+ * `accessor` (KHR_mesh_quantization) into 16-bit storage at `dst + i * dst_stride`, without
+ * going through floats. Signed components are re-biased to unsigned, so the returned decode
+ * turns every stored component back into the value `convert_accessor` produces. Sparse
+ * substitutions are applied in place.
+ * Returns nothing for float and 32-bit data, unsupported types and out-of-range data.
+ */
+std::optional<QuantizedVertexArray::Decode> copy_quantized_accessor(
+    const fastgltf::Asset &asset,
+    const fastgltf::Accessor &accessor,
+    uint32_t components,
+    std::byte *dst,
+    size_t dst_stride);
+
+/** Widen an index accessor (u8/u16/u32) into `dst`, which holds `accessor.count` indices. */
+bool convert_index_accessor(
+    const fastgltf::Asset &asset, const fastgltf::Accessor &accessor, uint32_t *dst);
+} // namespace importer
+} // namespace mr
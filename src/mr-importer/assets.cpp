@@ -9,6 +9,81 @@
 
 namespace mr {
 inline namespace importer {
+AffineTransform::AffineTransform(const Transform &transform) noexcept
+{
+  Transform matrix = transform;
+  for (int row = 0; row < 3; row++) {
+    for (int column = 0; column < 4; column++) {
+      rows[row][column] = matrix[row][column];
+    }
+  }
+}
+
+Transform AffineTransform::matrix() const noexcept
+{
+  // clang-format off
+  return Transform(
+      rows[0][0], rows[0][1], rows[0][2], rows[0][3],
+      rows[1][0], rows[1][1], rows[1][2], rows[1][3],
+      rows[2][0], rows[2][1], rows[2][2], rows[2][3],
+      0, 0, 0, 1);
+  // clang-format on
+}
+
+Position MeshAnimation::position(
+    const PositionArray &base, std::size_t frame, std::size_t vertex) const noexcept
+{
+  if (frame == 0 || position_deltas.empty()) {
+    return base[vertex];
+  }
+  const QuantizedDelta &delta = position_deltas[(frame - 1) * base.size() + vertex];
+  return {
+      base[vertex][0] + delta[0] * delta_scale[0],
+      base[vertex][1] + delta[1] * delta_scale[1],
+      base[vertex][2] + delta[2] * delta_scale[2],
+  };
+}
+
+PositionArray QuantizedVertexArray::dequantize_positions() const
+{
+  PositionArray result(positions.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, positions.size(), size_t{1} << 14),
+      [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+          result[i] = {position_decode(positions[i][0]),
+              position_decode(positions[i][1]),
+              position_decode(positions[i][2])};
+        }
+      });
+  return result;
+}
+
+void QuantizedVertexArray::dequantize_attributes(VertexAttributesArray &attributes) const
+{
+  DEBUG_ASSERT(normals.empty() || normals.size() == attributes.size());
+  DEBUG_ASSERT(texcoords.empty() || texcoords.size() == attributes.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, attributes.size(), size_t{1} << 14),
+      [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+          if (!normals.empty()) {
+            attributes[i].normal = {normal_decode(normals[i][0]),
+                normal_decode(normals[i][1]),
+                normal_decode(normals[i][2])};
+          }
+          if (!texcoords.empty()) {
+            attributes[i].texcoord = {
+                texcoord_decode(texcoords[i][0]), texcoord_decode(texcoords[i][1])};
+          }
+        }
+      });
+  if (!normals.empty()) {
+    attributes.is_normal_present = true;
+  }
+  if (!texcoords.empty()) {
+    attributes.is_texcoord_present = true;
+  }
+}
+
 /**
  * Construct an \ref Model by importing from a file path.
  * On failure, logs an error and leaves the instance default-initialized.
@@ -0,0 +1,191 @@
+/**
+ * \file bounds.cpp
+ * \brief Fused AABB and bounding sphere reduction over positions.
+ */
+
+#include "bounds.hpp"
+
+#include "pch.hpp"
+
+namespace mr {
+inline namespace importer {
+namespace {
+/** Positions per task; below this the passes run on the calling thread. */
+constexpr size_t bounds_grain = 1 << 15;
+
+/** Box plus the positions that touch its faces. */
+struct ExtremeReduction {
+  Position min {std::numeric_limits<float>::max(),
+      std::numeric_limits<float>::max(),
+      std::numeric_limits<float>::max()};
+  Position max {std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest()};
+  std::array<Position, 3> min_point {}; // Position with the smallest coordinate per axis
+  std::array<Position, 3> max_point {}; // Position with the largest coordinate per axis
+
+  void add(const Position *begin, const Position *end) noexcept
+  {
+    for (const Position *p = begin; p != end; p++) {
+      for (int axis = 0; axis < 3; axis++) {
+        const float v = (*p)[axis];
+        if (v < min[axis]) {
+          min[axis] = v;
+          min_point[axis] = *p;
+        }
+        if (v > max[axis]) {
+          max[axis] = v;
+          max_point[axis] = *p;
+        }
+      }
+    }
+  }
+
+  void join(const ExtremeReduction &other) noexcept
+  {
+    for (int axis = 0; axis < 3; axis++) {
+      if (other.min[axis] < min[axis]) {
+        min[axis] = other.min[axis];
+        min_point[axis] = other.min_point[axis];
+      }
+      if (other.max[axis] > max[axis]) {
+        max[axis] = other.max[axis];
+        max_point[axis] = other.max_point[axis];
+      }
+    }
+  }
+};
+
+struct Sphere {
+  Position center {};
+  float radius = 0;
+};
+
+static float distance_sq(const Position &a, const Position &b) noexcept
+{
+  const float dx = a[0] - b[0];
+  const float dy = a[1] - b[1];
+  const float dz = a[2] - b[2];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+/** Ritter growth: move the sphere towards every outside point just enough to cover it. */
+static void grow_sphere(Sphere &sphere, const Position *begin, const Position *end) noexcept
+{
+  float radius_sq = sphere.radius * sphere.radius;
+  for (const Position *p = begin; p != end; p++) {
+    const float dist_sq = distance_sq(*p, sphere.center);
+    if (dist_sq <= radius_sq) {
+      continue;
+    }
+
+    const float dist = std::sqrt(dist_sq);
+    const float new_radius = (sphere.radius + dist) * 0.5f;
+    const float alpha = (new_radius - sphere.radius) / dist;
+    for (int axis = 0; axis < 3; axis++) {
+      sphere.center[axis] += ((*p)[axis] - sphere.center[axis]) * alpha;
+    }
+    sphere.radius = new_radius;
+    radius_sq = new_radius * new_radius;
+  }
+}
+
+/** Smallest sphere enclosing both `a` and `b`. */
+static Sphere merge_spheres(const Sphere &a, const Sphere &b) noexcept
+{
+  const float dist = std::sqrt(distance_sq(a.center, b.center));
+  if (dist + b.radius <= a.radius) {
+    return a;
+  }
+  if (dist + a.radius <= b.radius) {
+    return b;
+  }
+
+  Sphere result;
+  result.radius = (dist + a.radius + b.radius) * 0.5f;
+  const float alpha = (result.radius - a.radius) / dist;
+  for (int axis = 0; axis < 3; axis++) {
+    result.center[axis] = a.center[axis] + (b.center[axis] - a.center[axis]) * alpha;
+  }
+  return result;
+}
+} // namespace
+
+MeshBounds calculate_bounds(const PositionArray &positions)
+{
+  ZoneScoped;
+
+  MeshBounds bounds;
+  if (positions.empty()) {
+    bounds.sphere = BoundingSphere(mr::Vec3f(0, 0, 0), 0.0f);
+    return bounds;
+  }
+
+  const Position *data = positions.data();
+  const tbb::blocked_range<size_t> range(0, positions.size(), bounds_grain);
+
+  // Pass 1: box and per-axis extreme points
+  const ExtremeReduction extremes = tbb::parallel_reduce(
+      range,
+      ExtremeReduction(),
+      [data](const tbb::blocked_range<size_t> &r, ExtremeReduction acc) {
+        acc.add(data + r.begin(), data + r.end());
+        return acc;
+      },
+      [](ExtremeReduction a, const ExtremeReduction &b) {
+        a.join(b);
+        return a;
+      });
+
+  bounds.aabb.min = {extremes.min[0], extremes.min[1], extremes.min[2]};
+  bounds.aabb.max = {extremes.max[0], extremes.max[1], extremes.max[2]};
+
+  // Seed with the most separated pair of axis extremes
+  int seed_axis = 0;
+  float seed_dist_sq = -1;
+  for (int axis = 0; axis < 3; axis++) {
+    const float dist_sq = distance_sq(extremes.min_point[axis], extremes.max_point[axis]);
+    if (dist_sq > seed_dist_sq) {
+      seed_dist_sq = dist_sq;
+      seed_axis = axis;
+    }
+  }
+
+  Sphere seed;
+  for (int axis = 0; axis < 3; axis++) {
+    seed.center[axis] =
+        (extremes.min_point[seed_axis][axis] + extremes.max_point[seed_axis][axis]) * 0.5f;
+  }
+  seed.radius = std::sqrt(seed_dist_sq) * 0.5f;
+
+  // Pass 2: grow the seed per chunk, then merge (every chunk sphere contains the seed)
+  const Sphere sphere = tbb::parallel_reduce(
+      range,
+      seed,
+      [data](const tbb::blocked_range<size_t> &r, Sphere acc) {
+        grow_sphere(acc, data + r.begin(), data + r.end());
+        return acc;
+      },
+      [](const Sphere &a, const Sphere &b) { return merge_spheres(a, b); });
+
+  const mr::Vec3f center(sphere.center[0], sphere.center[1], sphere.center[2]);
+  bounds.sphere = BoundingSphere(center, sphere.radius);
+  return bounds;
+}
+
+void update_mesh_bounds(Mesh &mesh)
+{
+  // Quantized positions are measured on a float copy that is dropped right after
+  PositionArray dequantized;
+  if (!mesh.quantized.empty()) {
+    dequantized = mesh.quantized.dequantize_positions();
+  }
+  const PositionArray &positions = mesh.quantized.empty() ? mesh.positions : dequantized;
+  MeshBounds bounds = calculate_bounds(positions);
+  if (!positions.empty()) {
+    mesh.aabb = bounds.aabb;
+  }
+  mesh.bounding_sphere = bounds.sphere;
+}
+} // namespace importer
+} // namespace mr
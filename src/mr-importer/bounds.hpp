@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * \file bounds.hpp
+ * \brief Internal AABB and bounding sphere computation shared by all loaders.
+ */
+
+#include "mr-importer/assets.hpp"
+
+namespace mr {
+inline namespace importer {
+/** Axis-aligned box and bounding sphere of a position array. */
+struct MeshBounds {
+  AABB aabb;
+  BoundingSphere sphere;
+};
+
+/**
+ * Compute the AABB and a Ritter-style bounding sphere of `positions`.
+ *
+ * The first pass reduces the AABB together with the extreme point along each axis,
+ * which seeds the sphere; the second pass grows the seed sphere per chunk and merges
+ * the chunk spheres. Both passes run as TBB reductions.
+ * Empty input yields a default AABB and a zero sphere.
+ */
+MeshBounds calculate_bounds(const PositionArray &positions);
+
+/**
+ * Store `calculate_bounds(mesh.positions)` into `mesh.aabb` and `mesh.bounding_sphere`,
+ * measuring the dequantized positions of a quantized mesh.
+ */
+void update_mesh_bounds(Mesh &mesh);
+} // namespace importer
+} // namespace mr
@@ -4,21 +4,23 @@
 
 #include "mr-importer/options.hpp"
 
+#include "mapped_file.hpp"
+
 namespace mr {
 inline namespace importer {
 struct Model;
-
-/** Opaque sync token for the loader/optimizer TBB graph (not dereferenced for USD). */
-inline void *usd_pipeline_token()
-{
-  return reinterpret_cast<void *>(uintptr_t{1});
-}
+struct UsdScene;
 
 // clang-format off
 struct FlowGraph {
+  std::vector<MappedFile> asset_buffers; // GLB and buffer files viewed by `asset`, must outlive it
+  std::vector<std::vector<std::byte>> decoded_buffers; // Decoded meshopt views viewed by `asset`
   std::optional<fastgltf::Asset> asset;
+  std::shared_ptr<UsdScene> usd_scene; // Opened stage shared by the USD loader nodes
+  std::atomic_uint usd_scene_users = 0; // USD loader nodes still reading `usd_scene`
   std::unique_ptr<Model> model;
   std::filesystem::path path;
+  UsdImportFilter usd_filter;
 
   tbb::flow::graph graph;
 
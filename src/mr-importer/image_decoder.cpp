@@ -0,0 +1,541 @@
+/**
+ * \file image_decoder.cpp
+ * \brief WUFFS image decoding with a parallel path for large restart-marked JPEGs.
+ */
+
+#include "image_decoder.hpp"
+
+#include "wuffs-v0.4.c"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "pch.hpp"
+
+#include <tbb/task_arena.h>
+
+#include "pixels.hpp"
+
+namespace mr {
+inline namespace importer {
+namespace {
+/**
+ * Banded JPEG decoding only pays off once a single image keeps one core busy for a while;
+ * below this size the per-band header copy and task overhead are not worth it.
+ */
+constexpr size_t tiled_decode_min_pixels = 2048 * 2048;
+
+/** Smallest band worth its own task, in pixel rows. */
+constexpr uint32_t tiled_decode_min_band_rows = 256;
+
+/** Final pixel layout of a decoded image. */
+struct DecodeLayout {
+  uint32_t decoded_components = 4; // Components WUFFS writes
+  uint32_t components = 4;         // Components in \ref ImageData, zero/opaque padded
+  vk::Format format = vk::Format::eR8G8B8A8Srgb;
+  uint32_t wuffs_format = WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL;
+
+  size_t stride(uint32_t width) const noexcept { return size_t(width) * components; }
+};
+
+/** Pick the destination layout from the source format and the Allow*ComponentImages options. */
+static DecodeLayout select_layout(bool is_gray, bool is_opaque, Options options)
+{
+  if (is_gray && is_enabled(options, Options::Allow1ComponentImages)) {
+    return {1, 1, vk::Format::eR8Srgb, WUFFS_BASE__PIXEL_FORMAT__Y};
+  }
+  if (is_gray && is_enabled(options, Options::Allow2ComponentImages)) {
+    MR_INFO("Resizing an image from 1-component to 2-component. Consider "
+            "doing it offline");
+    return {1, 2, vk::Format::eR8G8Srgb, WUFFS_BASE__PIXEL_FORMAT__Y};
+  }
+  if (is_opaque && is_enabled(options, Options::Allow3ComponentImages)) {
+    return {3, 3, vk::Format::eB8G8R8Srgb, WUFFS_BASE__PIXEL_FORMAT__BGR};
+  }
+  if (!is_opaque && !is_enabled(options, Options::Allow4ComponentImages)) {
+    MR_ERROR("Disallowing 4-component images makes lossless import impossible. "
+             "Transfer your images to 3-components (or less) offline!");
+  }
+  return {};
+}
+
+/**
+ * Widen rows that WUFFS decoded with fewer components into the front of each final row.
+ * Rows are independent, so unlike one whole-image in-place pass this parallelizes.
+ */
+static void widen_rows(
+    std::byte *pixels, uint32_t width, uint32_t height, const DecodeLayout &layout)
+{
+  if (layout.decoded_components == layout.components) {
+    return;
+  }
+
+  ZoneScoped;
+
+  const size_t stride = layout.stride(width);
+  tbb::parallel_for(tbb::blocked_range<uint32_t>(0, height),
+      [&](const tbb::blocked_range<uint32_t> &range) {
+        for (uint32_t y = range.begin(); y < range.end(); y++) {
+          expand_channels_in_place(pixels + y * stride,
+              width,
+              {.src_components = layout.decoded_components, .dst_components = layout.components});
+        }
+      });
+}
+
+/**
+ * WUFFS callbacks that decode straight into the final \ref ImageData layout.
+ *
+ * Either the layout is picked from the source format and the pixel buffer is allocated
+ * here with its final size, or both are given by the caller (used for JPEG bands that
+ * land directly in the rows of a shared image).
+ */
+class ImageDecodeCallbacks : public wuffs_aux::DecodeImageCallbacks {
+public:
+  explicit ImageDecodeCallbacks(Options options) : _options(options) {}
+
+  /** Decode a `width` x `height` image with a known layout into caller-owned memory. */
+  ImageDecodeCallbacks(
+      const DecodeLayout &layout, std::byte *target, uint32_t width, uint32_t height)
+    : _layout(layout), _has_layout(true), _target(target), _width(width), _height(height)
+  {
+  }
+
+  /** Run WUFFS over `input`, returns false (and logs) on failure. */
+  bool decode(wuffs_aux::sync_io::Input &input)
+  {
+    wuffs_aux::DecodeImageResult img = wuffs_aux::DecodeImage(*this, input);
+
+    if (!img.error_message.empty()) {
+      MR_INFO("Failed to parse image: {}", img.error_message);
+      return false;
+    }
+    if (!img.pixbuf.pixcfg.is_valid()) {
+      MR_INFO("Failed to parse image for unknown reason");
+      return false;
+    }
+
+    widen_rows(pixels(), _width, _height, _layout);
+    return true;
+  }
+
+  /** Move the decoded pixels into `image`, returns false if nothing was decoded. */
+  bool finish(ImageData &image)
+  {
+    if (_pixels.get() == nullptr) {
+      return false;
+    }
+
+    image.width = _width;
+    image.height = _height;
+    image.bytes_per_pixel = _layout.components;
+    image.format = _layout.format;
+    image.pixels = std::move(_pixels);
+    image.pixels.size(_layout.stride(_width) * _height);
+    image.mips.emplace_back(image.pixels.get(), image.pixels.size());
+    return true;
+  }
+
+private:
+  std::byte *pixels() noexcept { return _target != nullptr ? _target : _pixels.get(); }
+
+  wuffs_base__pixel_format SelectPixfmt(const wuffs_base__image_config &image_config) override
+  {
+    if (!_has_layout) {
+      const wuffs_base__pixel_format source = image_config.pixcfg.pixel_format();
+      const bool is_gray = source.repr == WUFFS_BASE__PIXEL_FORMAT__Y ||
+                           source.repr == WUFFS_BASE__PIXEL_FORMAT__Y_16LE ||
+                           source.repr == WUFFS_BASE__PIXEL_FORMAT__Y_16BE;
+      const bool is_opaque = source.transparency() == WUFFS_BASE__PIXEL_ALPHA_TRANSPARENCY__OPAQUE;
+      _layout = select_layout(is_gray, is_opaque, _options);
+    }
+    return wuffs_base__make_pixel_format(_layout.wuffs_format);
+  }
+
+  AllocPixbufResult AllocPixbuf(
+      const wuffs_base__image_config &image_config, bool allow_uninitialized_memory) override
+  {
+    const uint32_t width = image_config.pixcfg.width();
+    const uint32_t height = image_config.pixcfg.height();
+    if (width == 0 || height == 0) {
+      return AllocPixbufResult("");
+    }
+
+    if (_target != nullptr) {
+      if (width != _width || height != _height) {
+        return AllocPixbufResult("image size differs from the expected one");
+      }
+    }
+    else {
+      _width = width;
+      _height = height;
+      const size_t byte_size = _layout.stride(_width) * _height;
+      _pixels = allow_uninitialized_memory ? std::make_unique_for_overwrite<std::byte[]>(byte_size)
+                                           : std::make_unique<std::byte[]>(byte_size);
+    }
+
+    // Rows keep their final stride; narrower decodes are widened per row afterwards
+    const size_t stride = _layout.stride(_width);
+    wuffs_base__pixel_buffer pixbuf;
+    wuffs_base__status status = pixbuf.set_interleaved(&image_config.pixcfg,
+        wuffs_base__make_table_u8(
+            (uint8_t *)pixels(), size_t(_width) * _layout.decoded_components, _height, stride),
+        wuffs_base__empty_slice_u8());
+    if (!status.is_ok()) {
+      _pixels.reset();
+      return AllocPixbufResult(std::string(status.message()));
+    }
+
+    // Memory is owned by the callbacks or the caller, WUFFS gets a non-owning pixel buffer
+    return AllocPixbufResult(wuffs_aux::MemOwner(nullptr, &free), pixbuf);
+  }
+
+  Options _options = Options::None;
+  DecodeLayout _layout;
+  bool _has_layout = false;
+  std::byte *_target = nullptr;
+  std::unique_ptr<std::byte[]> _pixels;
+  uint32_t _width = 0;
+  uint32_t _height = 0;
+};
+
+/**
+ * Baseline JPEG split at its restart markers.
+ *
+ * Each restart interval resets the entropy decoder state, so a run of whole intervals
+ * plus the original header is a valid JPEG of its own.
+ */
+struct JpegScan {
+  std::span<const std::byte> header; // SOI up to and including the SOS segment
+  size_t height_offset = 0;          // Offset of the SOF height field inside `header`
+  std::vector<std::span<const std::byte>> intervals;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t components = 0;
+  uint32_t mcu_width = 8;
+  uint32_t mcu_height = 8;
+  uint32_t restart_interval = 0; // In MCUs
+  bool subsampled = false;
+
+  uint32_t mcus_per_row() const noexcept { return (width + mcu_width - 1) / mcu_width; }
+  uint32_t mcu_rows() const noexcept { return (height + mcu_height - 1) / mcu_height; }
+};
+
+static uint8_t jpeg_byte(std::span<const std::byte> data, size_t offset)
+{
+  return std::to_integer<uint8_t>(data[offset]);
+}
+
+static uint16_t jpeg_u16(std::span<const std::byte> data, size_t offset)
+{
+  return uint16_t(jpeg_byte(data, offset) << 8 | jpeg_byte(data, offset + 1));
+}
+
+/**
+ * Parse the markers of a JPEG and split its scan into restart intervals.
+ * Returns nothing for anything but a single-scan 8-bit baseline Huffman JPEG with
+ * restart markers, those are decoded in one piece.
+ */
+static std::optional<JpegScan> parse_jpeg_scan(std::span<const std::byte> data)
+{
+  ZoneScoped;
+
+  if (data.size() < 4 || jpeg_byte(data, 0) != 0xFF || jpeg_byte(data, 1) != 0xD8) {
+    return std::nullopt;
+  }
+
+  JpegScan jpeg;
+  bool has_frame = false;
+  size_t pos = 2;
+  while (true) {
+    if (pos + 4 > data.size() || jpeg_byte(data, pos) != 0xFF) {
+      return std::nullopt;
+    }
+    // Skip fill bytes
+    while (pos + 4 < data.size() && jpeg_byte(data, pos + 1) == 0xFF) {
+      pos++;
+    }
+
+    const uint8_t marker = jpeg_byte(data, pos + 1);
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) {
+      return std::nullopt;
+    }
+
+    const size_t length = jpeg_u16(data, pos + 2);
+    const size_t payload = pos + 4;
+    const size_t next = pos + 2 + length;
+    if (length < 2 || next > data.size()) {
+      return std::nullopt;
+    }
+
+    if (marker == 0xC0 || marker == 0xC1) {
+      if (length < 8) {
+        return std::nullopt;
+      }
+      jpeg.height_offset = payload + 1;
+      jpeg.height = jpeg_u16(data, payload + 1);
+      jpeg.width = jpeg_u16(data, payload + 3);
+      jpeg.components = jpeg_byte(data, payload + 5);
+      if (jpeg_byte(data, payload) != 8 || (jpeg.components != 1 && jpeg.components != 3) ||
+          length < 8 + 3 * jpeg.components) {
+        return std::nullopt;
+      }
+
+      uint32_t max_h = 1;
+      uint32_t max_v = 1;
+      for (uint32_t c = 0; c < jpeg.components; c++) {
+        const uint8_t sampling = jpeg_byte(data, payload + 6 + 3 * c + 1);
+        if ((sampling >> 4) == 0 || (sampling & 0xF) == 0) {
+          return std::nullopt;
+        }
+        max_h = std::max<uint32_t>(max_h, sampling >> 4);
+        max_v = std::max<uint32_t>(max_v, sampling & 0xF);
+      }
+      for (uint32_t c = 0; c < jpeg.components && jpeg.components > 1; c++) {
+        const uint8_t sampling = jpeg_byte(data, payload + 6 + 3 * c + 1);
+        jpeg.subsampled |= (sampling >> 4) != max_h || (sampling & 0xF) != max_v;
+      }
+
+      // A non-interleaved single component scan always has 8x8 MCUs
+      if (jpeg.components > 1) {
+        jpeg.mcu_width = 8 * max_h;
+        jpeg.mcu_height = 8 * max_v;
+      }
+      has_frame = true;
+    }
+    else if (marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+             marker != 0xCC) {
+      // Progressive, lossless, hierarchical or arithmetic coded
+      return std::nullopt;
+    }
+    else if (marker == 0xDD) {
+      if (length < 4) {
+        return std::nullopt;
+      }
+      jpeg.restart_interval = jpeg_u16(data, payload);
+    }
+    else if (marker == 0xDA) {
+      if (!has_frame || length < 3 || jpeg_byte(data, payload) != jpeg.components) {
+        return std::nullopt;
+      }
+      jpeg.header = data.first(next);
+      pos = next;
+      break;
+    }
+    pos = next;
+  }
+
+  if (jpeg.restart_interval == 0 || jpeg.width == 0 || jpeg.height == 0) {
+    return std::nullopt;
+  }
+
+  size_t begin = pos;
+  bool has_end = false;
+  for (size_t i = pos; i + 1 < data.size() && !has_end; i++) {
+    if (jpeg_byte(data, i) != 0xFF) {
+      continue;
+    }
+    size_t last_fill = i;
+    while (last_fill + 1 < data.size() && jpeg_byte(data, last_fill + 1) == 0xFF) {
+      last_fill++;
+    }
+    if (last_fill + 1 >= data.size()) {
+      break;
+    }
+
+    const uint8_t marker = jpeg_byte(data, last_fill + 1);
+    if (marker == 0x00) {
+      // Stuffed 0xFF data byte
+      i = last_fill + 1;
+      continue;
+    }
+    if (marker >= 0xD0 && marker <= 0xD7) {
+      jpeg.intervals.push_back(data.subspan(begin, i - begin));
+      begin = last_fill + 2;
+      i = last_fill + 1;
+      continue;
+    }
+    if (marker != 0xD9) {
+      // DNL, a second scan or garbage
+      return std::nullopt;
+    }
+    jpeg.intervals.push_back(data.subspan(begin, i - begin));
+    has_end = true;
+  }
+
+  const size_t total_mcus = size_t(jpeg.mcus_per_row()) * jpeg.mcu_rows();
+  const size_t expected_intervals =
+      (total_mcus + jpeg.restart_interval - 1) / jpeg.restart_interval;
+  if (!has_end || jpeg.intervals.size() != expected_intervals) {
+    return std::nullopt;
+  }
+
+  return jpeg;
+}
+
+/** Assemble a standalone JPEG from intervals [first, last) that is `height` pixels tall. */
+static std::vector<std::byte> make_jpeg_band(
+    const JpegScan &jpeg, size_t first, size_t last, uint32_t height)
+{
+  size_t size = jpeg.header.size() + 2;
+  for (size_t i = first; i < last; i++) {
+    size += jpeg.intervals[i].size() + 2;
+  }
+
+  std::vector<std::byte> band;
+  band.reserve(size);
+  band.insert(band.end(), jpeg.header.begin(), jpeg.header.end());
+  band[jpeg.height_offset] = std::byte(height >> 8);
+  band[jpeg.height_offset + 1] = std::byte(height & 0xFF);
+
+  for (size_t i = first; i < last; i++) {
+    if (i != first) {
+      // Restart markers count RST0..RST7 from the start of the scan
+      band.push_back(std::byte(0xFF));
+      band.push_back(std::byte(0xD0 + (i - first - 1) % 8));
+    }
+    band.insert(band.end(), jpeg.intervals[i].begin(), jpeg.intervals[i].end());
+  }
+  band.push_back(std::byte(0xFF));
+  band.push_back(std::byte(0xD9));
+  return band;
+}
+
+/**
+ * Split a JPEG into bands of MCU rows that start on restart boundaries.
+ * Returns band boundaries in MCU rows (first is 0, last is mcu_rows), or fewer than
+ * 3 entries when the image should not be split.
+ */
+static std::vector<uint32_t> plan_jpeg_bands(const JpegScan &jpeg)
+{
+  if (size_t(jpeg.width) * jpeg.height < tiled_decode_min_pixels) {
+    return {};
+  }
+
+  // Band starts must be both whole MCU rows and whole restart intervals
+  const uint32_t mcus_per_row = jpeg.mcus_per_row();
+  const uint32_t row_step =
+      jpeg.restart_interval / std::gcd(jpeg.restart_interval, mcus_per_row);
+  const uint32_t mcu_rows = jpeg.mcu_rows();
+  const uint32_t steps = (mcu_rows + row_step - 1) / row_step;
+
+  const size_t band_count = std::min<size_t>({
+      size_t(tbb::this_task_arena::max_concurrency()),
+      size_t(steps),
+      size_t(jpeg.height / tiled_decode_min_band_rows),
+  });
+  if (band_count < 2) {
+    return {};
+  }
+
+  std::vector<uint32_t> bounds(band_count + 1);
+  for (size_t b = 0; b <= band_count; b++) {
+    bounds[b] = std::min<uint32_t>(uint32_t(b * steps / band_count) * row_step, mcu_rows);
+  }
+  return bounds;
+}
+
+/**
+ * Decode JPEG bands in parallel into one image.
+ *
+ * Without chroma subsampling every band is written straight into its final rows.
+ * Subsampled chroma is upsampled with a filter that looks at neighbouring rows, so those
+ * bands are decoded with one extra restart-aligned step above and below and only their
+ * interior rows are copied, keeping the result identical to a single-pass decode.
+ */
+static bool decode_jpeg_bands(const JpegScan &jpeg,
+    const std::vector<uint32_t> &bounds,
+    Options options,
+    ImageData &image)
+{
+  ZoneScoped;
+
+  const DecodeLayout layout = select_layout(jpeg.components == 1, true, options);
+  const size_t stride = layout.stride(jpeg.width);
+  const size_t byte_size = stride * jpeg.height;
+  std::unique_ptr<std::byte[]> pixels = std::make_unique_for_overwrite<std::byte[]>(byte_size);
+
+  const uint32_t mcus_per_row = jpeg.mcus_per_row();
+  const uint32_t mcu_rows = jpeg.mcu_rows();
+  const uint32_t row_step = jpeg.restart_interval / std::gcd(jpeg.restart_interval, mcus_per_row);
+  const uint32_t overlap = jpeg.subsampled ? row_step : 0;
+
+  std::atomic_bool success = true;
+  tbb::parallel_for(size_t(0), bounds.size() - 1, [&](size_t band) {
+    ZoneScopedN("JPEG band decode");
+
+    const uint32_t begin_row = bounds[band];
+    const uint32_t end_row = bounds[band + 1];
+    const uint32_t decode_begin_row = begin_row - std::min(begin_row, overlap);
+    const uint32_t decode_end_row = std::min(mcu_rows, end_row + overlap);
+
+    const size_t first = size_t(decode_begin_row) * mcus_per_row / jpeg.restart_interval;
+    const size_t last = decode_end_row == mcu_rows
+                            ? jpeg.intervals.size()
+                            : size_t(decode_end_row) * mcus_per_row / jpeg.restart_interval;
+
+    const uint32_t y0 = decode_begin_row * jpeg.mcu_height;
+    const uint32_t y1 = std::min(decode_end_row * jpeg.mcu_height, jpeg.height);
+    const std::vector<std::byte> data = make_jpeg_band(jpeg, first, last, y1 - y0);
+    wuffs_aux::sync_io::MemoryInput input((const char *)data.data(), data.size());
+
+    if (overlap == 0) {
+      ImageDecodeCallbacks callbacks(layout, pixels.get() + y0 * stride, jpeg.width, y1 - y0);
+      if (!callbacks.decode(input)) {
+        success = false;
+      }
+      return;
+    }
+
+    auto scratch = std::make_unique_for_overwrite<std::byte[]>(stride * (y1 - y0));
+    ImageDecodeCallbacks callbacks(layout, scratch.get(), jpeg.width, y1 - y0);
+    if (!callbacks.decode(input)) {
+      success = false;
+      return;
+    }
+
+    const uint32_t copy_begin = begin_row * jpeg.mcu_height;
+    const uint32_t copy_end = std::min(end_row * jpeg.mcu_height, jpeg.height);
+    std::memcpy(pixels.get() + copy_begin * stride,
+        scratch.get() + (copy_begin - y0) * stride,
+        (copy_end - copy_begin) * stride);
+  });
+
+  if (!success) {
+    return false;
+  }
+
+  image.width = jpeg.width;
+  image.height = jpeg.height;
+  image.bytes_per_pixel = layout.components;
+  image.format = layout.format;
+  image.pixels = std::move(pixels);
+  image.pixels.size(byte_size);
+  image.mips.emplace_back(image.pixels.get(), image.pixels.size());
+  return true;
+}
+} // namespace
+
+bool decode_wuffs_image(std::span<const std::byte> data, Options options, ImageData &image)
+{
+  ZoneScoped;
+
+  if (std::optional<JpegScan> jpeg = parse_jpeg_scan(data)) {
+    const std::vector<uint32_t> bounds = plan_jpeg_bands(*jpeg);
+    if (bounds.size() >= 3) {
+      if (decode_jpeg_bands(*jpeg, bounds, options, image)) {
+        return true;
+      }
+      MR_INFO("Banded JPEG decode failed, retrying in one pass");
+    }
+  }
+
+  wuffs_aux::sync_io::MemoryInput input((const char *)data.data(), data.size());
+  ImageDecodeCallbacks callbacks(options);
+  return callbacks.decode(input) && callbacks.finish(image);
+}
+} // namespace importer
+} // namespace mr
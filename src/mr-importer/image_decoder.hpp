@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * \file image_decoder.hpp
+ * \brief Internal WUFFS-based decoding of PNG/JPEG/... images into \ref ImageData.
+ */
+
+#include "mr-importer/assets.hpp"
+#include "mr-importer/options.hpp"
+
+#include <span>
+
+namespace mr {
+inline namespace importer {
+/**
+ * Decode an in-memory (or mapped) image straight into its final layout.
+ *
+ * Very large baseline JPEGs with restart markers are split into horizontal
+ * bands that are decoded in parallel.
+ */
+bool decode_wuffs_image(std::span<const std::byte> data, Options options, ImageData &image);
+} // namespace importer
+} // namespace mr
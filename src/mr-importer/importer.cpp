@@ -29,6 +29,12 @@ bool is_usd_extension(std::filesystem::path const &path)
  * \return Imported \ref Model or std::nullopt if loading failed.
  */
 std::optional<Model> import(const std::filesystem::path &path, Options options)
+{
+  return import(path, options, UsdImportFilter{});
+}
+
+std::optional<Model> import(
+    const std::filesystem::path &path, Options options, const UsdImportFilter &usd_filter)
 {
   ZoneScoped;
 
@@ -38,6 +44,7 @@ std::optional<Model> import(const std::filesystem::path &path, Options options)
 
   FlowGraph graph;
   graph.path = std::move(path);
+  graph.usd_filter = usd_filter;
 
   if (is_usd_extension(graph.path)) {
     add_usd_loader_nodes(graph, options);
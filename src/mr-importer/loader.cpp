@@ -3,8 +3,6 @@
  * \brief glTF loading and conversion into runtime asset structures.
  */
 
-#include "wuffs-v0.4.c"
-
 #include <dds.hpp>
 
 #include <KHR/khr_df.h>
@@ -15,14 +13,23 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iterator>
+#include <limits>
+#include <numeric>
 
 #include "mr-importer/importer.hpp"
 
 #include "pch.hpp"
 
+#include "accessors.hpp"
+#include "bounds.hpp"
 #include "flowgraph.hpp"
+#include "image_decoder.hpp"
+#include "mapped_file.hpp"
+#include "pixels.hpp"
 
 namespace mr {
 inline namespace importer {
@@ -32,31 +39,313 @@ uint32_t ImageData::pixel_byte_size() const noexcept
 }
 
 namespace {
+/**
+ * Replace every external (.bin) buffer URI of `asset` with a view into a file mapping.
+ * The mappings are appended to `mappings` and must outlive the asset.
+ */
+static bool map_external_buffers(fastgltf::Asset &asset,
+    const std::filesystem::path &directory,
+    std::vector<MappedFile> &mappings)
+{
+  ZoneScoped;
+
+  for (fastgltf::Buffer &buffer : asset.buffers) {
+    const auto *uri = std::get_if<fastgltf::sources::URI>(&buffer.data);
+    if (uri == nullptr) {
+      continue;
+    }
+    if (!uri->uri.isLocalPath()) {
+      MR_ERROR("Only local buffer files are supported, got {}", uri->uri.c_str());
+      return false;
+    }
+
+    std::optional<MappedFile> file = MappedFile::open(directory / uri->uri.fspath());
+    if (!file.has_value()) {
+      return false;
+    }
+    if (uri->fileByteOffset > file->size() ||
+        buffer.byteLength > file->size() - uri->fileByteOffset) {
+      MR_ERROR("Buffer file {} is smaller than its declared length", uri->uri.c_str());
+      return false;
+    }
+
+    const std::byte *bytes = file->data() + uri->fileByteOffset;
+    buffer.data = fastgltf::sources::ByteView{
+        .bytes = fastgltf::span<const std::byte>(bytes, buffer.byteLength),
+        .mimeType = fastgltf::MimeType::GltfBuffer,
+    };
+    mappings.emplace_back(std::move(*file));
+  }
+
+  return true;
+}
+
+/** Run meshoptimizer's decoder and filter for one EXT_meshopt_compression buffer view. */
+static bool decode_meshopt_view(
+    const fastgltf::CompressedBufferView &compressed, const std::byte *src, std::byte *dst)
+{
+  using fastgltf::MeshoptCompressionFilter;
+  using fastgltf::MeshoptCompressionMode;
+
+  const auto *source = reinterpret_cast<const unsigned char *>(src);
+  int result = -1;
+  switch (compressed.mode) {
+  case MeshoptCompressionMode::Attributes:
+    result = meshopt_decodeVertexBuffer(
+        dst, compressed.count, compressed.byteStride, source, compressed.byteLength);
+    break;
+  case MeshoptCompressionMode::Triangles:
+    result = meshopt_decodeIndexBuffer(
+        dst, compressed.count, compressed.byteStride, source, compressed.byteLength);
+    break;
+  case MeshoptCompressionMode::Indices:
+    result = meshopt_decodeIndexSequence(
+        dst, compressed.count, compressed.byteStride, source, compressed.byteLength);
+    break;
+  }
+  if (result != 0) {
+    return false;
+  }
+
+  switch (compressed.filter) {
+  case MeshoptCompressionFilter::None:
+    break;
+  case MeshoptCompressionFilter::Octahedral:
+    meshopt_decodeFilterOct(dst, compressed.count, compressed.byteStride);
+    break;
+  case MeshoptCompressionFilter::Quaternion:
+    meshopt_decodeFilterQuat(dst, compressed.count, compressed.byteStride);
+    break;
+  case MeshoptCompressionFilter::Exponential:
+    meshopt_decodeFilterExp(dst, compressed.count, compressed.byteStride);
+    break;
+  }
+  return true;
+}
+
+/**
+ * Decode every EXT_meshopt_compression buffer view of `asset` in parallel.
+ *
+ * Each view is decoded into its own allocation in `decoded`, exposed to fastgltf as a new
+ * buffer, and the view is repointed at it, so accessors and images read it like any
+ * uncompressed view. `decoded` must outlive the asset.
+ */
+static bool decode_meshopt_buffer_views(
+    fastgltf::Asset &asset, std::vector<std::vector<std::byte>> &decoded)
+{
+  ZoneScoped;
+
+  std::vector<size_t> compressed_views;
+  for (size_t i = 0; i < asset.bufferViews.size(); i++) {
+    if (asset.bufferViews[i].meshoptCompression != nullptr) {
+      compressed_views.push_back(i);
+    }
+  }
+  if (compressed_views.empty()) {
+    return true;
+  }
+
+  const size_t first_decoded = decoded.size();
+  decoded.resize(first_decoded + compressed_views.size());
+
+  std::atomic_bool error = false;
+  tbb::parallel_for(size_t(0), compressed_views.size(), [&](size_t i) {
+    const fastgltf::CompressedBufferView &compressed =
+        *asset.bufferViews[compressed_views[i]].meshoptCompression;
+
+    const std::span<const std::byte> source =
+        get_buffer_bytes(asset.buffers[compressed.bufferIndex]);
+    if (compressed.byteOffset > source.size() ||
+        compressed.byteLength > source.size() - compressed.byteOffset) {
+      MR_ERROR("Meshopt compressed buffer view {} is out of range", compressed_views[i]);
+      error = true;
+      return;
+    }
+
+    std::vector<std::byte> &bytes = decoded[first_decoded + i];
+    bytes.resize(compressed.count * compressed.byteStride);
+    if (!decode_meshopt_view(compressed, source.data() + compressed.byteOffset, bytes.data())) {
+      MR_ERROR("Failed to decode meshopt compressed buffer view {}", compressed_views[i]);
+      error = true;
+    }
+  });
+  if (error) {
+    return false;
+  }
+
+  for (size_t i = 0; i < compressed_views.size(); i++) {
+    const std::vector<std::byte> &bytes = decoded[first_decoded + i];
+
+    fastgltf::Buffer buffer;
+    buffer.byteLength = bytes.size();
+    buffer.data = fastgltf::sources::ByteView{
+        .bytes = fastgltf::span<const std::byte>(bytes.data(), bytes.size()),
+        .mimeType = fastgltf::MimeType::GltfBuffer,
+    };
+
+    fastgltf::BufferView &view = asset.bufferViews[compressed_views[i]];
+    view.bufferIndex = asset.buffers.size();
+    view.byteOffset = 0;
+    view.byteLength = bytes.size();
+    view.meshoptCompression.reset();
+    asset.buffers.emplace_back(std::move(buffer));
+  }
+
+  return true;
+}
+
+/**
+ * glTF/GLB file served to the fastgltf parser from a memory mapping.
+ *
+ * fastgltf reads the GLB BIN chunk into memory handed out by the buffer allocation
+ * callback. `allocate` hands out the chunk's own mapped bytes and `read` skips copying a
+ * range onto itself, so the chunk is viewed in place instead of duplicated on the heap.
+ * Everything else fastgltf allocates (base64 data URIs) gets a heap vector.
+ */
+class MappedGltfData : public fastgltf::GltfDataGetter {
+public:
+  explicit MappedGltfData(const MappedFile &file) : _file(file) {}
+
+  void read(void *ptr, std::size_t count) override
+  {
+    count = std::min(count, _file.size() - _offset);
+    const std::byte *src = _file.data() + _offset;
+    if (ptr != src) {
+      std::memcpy(ptr, src, count);
+    }
+    _offset += count;
+  }
+
+  fastgltf::span<std::byte> read(std::size_t count, std::size_t padding) override
+  {
+    // The JSON chunk goes to simdjson, which needs zeroed padding past its end
+    count = std::min(count, _file.size() - _offset);
+    _padded.assign(count + padding, std::byte(0));
+    std::memcpy(_padded.data(), _file.data() + _offset, count);
+    _offset += count;
+    return fastgltf::span<std::byte>(_padded.data(), count);
+  }
+
+  void reset() override { _offset = 0; }
+  std::size_t bytesRead() override { return _offset; }
+  std::size_t totalSize() override { return _file.size(); }
+
+  /** fastgltf::BufferMapCallback, `user_pointer` is the MappedGltfData being parsed. */
+  static fastgltf::BufferInfo allocate(std::uint64_t size, void *user_pointer)
+  {
+    auto &self = *static_cast<MappedGltfData *>(user_pointer);
+    const fastgltf::CustomBufferId id = self._allocations.size();
+    if (self.at_glb_binary_chunk(size)) {
+      self._glb_binary_chunk = id;
+      self._allocations.emplace_back();
+      // Never written through: `read` recognizes the range and leaves it alone
+      return {const_cast<std::byte *>(self._file.data() + self._offset), id};
+    }
+    std::vector<std::byte> &bytes = self._allocations.emplace_back(size);
+    return {bytes.data(), id};
+  }
+
+  /**
+   * Replace the custom sources `allocate` produced: the GLB BIN chunk becomes a view into
+   * the mapping, heap allocations are moved into vector sources.
+   */
+  void resolve(fastgltf::Asset &asset)
+  {
+    auto resolve_source = [&](fastgltf::DataSource &source, bool is_buffer) {
+      const auto *custom = std::get_if<fastgltf::sources::CustomBuffer>(&source);
+      if (custom == nullptr || custom->id >= _allocations.size()) {
+        return;
+      }
+      if (is_buffer && custom->id == _glb_binary_chunk) {
+        source = fastgltf::sources::ByteView{
+            .bytes = fastgltf::span<const std::byte>(_file.data() + _glb_binary_offset,
+                _glb_binary_size),
+            .mimeType = fastgltf::MimeType::GltfBuffer,
+        };
+        return;
+      }
+      const fastgltf::MimeType mime_type = custom->mimeType;
+      source = fastgltf::sources::Vector{
+          .bytes = std::move(_allocations[custom->id]),
+          .mimeType = mime_type,
+      };
+    };
+
+    for (fastgltf::Buffer &buffer : asset.buffers) {
+      resolve_source(buffer.data, true);
+    }
+    for (fastgltf::Image &image : asset.images) {
+      resolve_source(image.data, false);
+    }
+  }
+
+  /** Whether the resolved asset views the mapping, which then has to outlive it. */
+  bool views_file() const noexcept { return _glb_binary_chunk != no_chunk; }
+
+private:
+  /** Whether the parser has just read the header of a GLB BIN chunk of `size` bytes. */
+  bool at_glb_binary_chunk(std::uint64_t size)
+  {
+    constexpr std::uint32_t glb_magic = 0x46546C67; // "glTF"
+    constexpr std::uint32_t bin_chunk_type = 0x004E4942; // "BIN\0"
+
+    std::uint32_t magic = 0;
+    std::uint32_t chunk[2] = {}; // Length, type
+    if (_glb_binary_chunk != no_chunk || _file.size() < 12 || _offset < 12 + sizeof(chunk) ||
+        size > _file.size() - _offset) {
+      return false;
+    }
+    std::memcpy(&magic, _file.data(), sizeof(magic));
+    std::memcpy(chunk, _file.data() + _offset - sizeof(chunk), sizeof(chunk));
+    if (magic != glb_magic || chunk[1] != bin_chunk_type || chunk[0] != size) {
+      return false;
+    }
+
+    _glb_binary_offset = _offset;
+    _glb_binary_size = size;
+    return true;
+  }
+
+  static constexpr fastgltf::CustomBufferId no_chunk =
+      std::numeric_limits<fastgltf::CustomBufferId>::max();
+
+  const MappedFile &_file;
+  size_t _offset = 0;
+  std::vector<std::byte> _padded;
+  std::vector<std::vector<std::byte>> _allocations; // By custom buffer id
+  fastgltf::CustomBufferId _glb_binary_chunk = no_chunk;
+  size_t _glb_binary_offset = 0;
+  size_t _glb_binary_size = 0;
+};
+
 /**
  * Parse a glTF file into a fastgltf::Asset.
  *
  * On IO or parse error, logs an error with the fastgltf code and returns
- * std::nullopt. Uses LoadExternalBuffers/Images to resolve external data.
+ * std::nullopt. The glTF/GLB file and external buffers are mapped into `mappings`
+ * instead of being copied to the heap, and the GLB BIN chunk is viewed straight from
+ * its mapping. Meshopt compressed buffer views are decoded into `decoded`.
  */
-static std::optional<fastgltf::Asset> get_asset_from_path(const std::filesystem::path &path)
+static std::optional<fastgltf::Asset> get_asset_from_path(const std::filesystem::path &path,
+    std::vector<MappedFile> &mappings,
+    std::vector<std::vector<std::byte>> &decoded)
 {
   using namespace fastgltf;
 
   ZoneScoped;
-  auto [err, data] = GltfDataBuffer::FromPath(path);
-  if (err != Error::None) {
-    MR_ERROR("Failed to parse GLTF file\n"
-             "\t\t{}: {}",
-        getErrorName(err),
-        getErrorMessage(err));
+  std::optional<MappedFile> file = MappedFile::open(path);
+  if (!file.has_value()) {
     return std::nullopt; // Failed to load GLTF data
   }
+  MappedGltfData data(*file);
 
   // clang-format off
   auto extensions =
       fastgltf::Extensions::KHR_lights_punctual |
       fastgltf::Extensions::KHR_materials_pbrSpecularGlossiness |
       fastgltf::Extensions::KHR_draco_mesh_compression |
+      fastgltf::Extensions::KHR_mesh_quantization |
+      fastgltf::Extensions::EXT_meshopt_compression |
       fastgltf::Extensions::EXT_mesh_gpu_instancing |
       fastgltf::Extensions::EXT_texture_webp |
       fastgltf::Extensions::MSFT_texture_dds |
@@ -65,8 +354,10 @@ static std::optional<fastgltf::Asset> get_asset_from_path(const std::filesystem:
   // clang-format on
 
   Parser parser(extensions);
-  auto options =
-      fastgltf::Options::LoadExternalBuffers | fastgltf::Options::DontRequireValidAssetMember;
+  parser.setUserPointer(&data);
+  parser.setBufferAllocationCallback(MappedGltfData::allocate);
+  // External buffers are mapped below rather than loaded by fastgltf
+  auto options = fastgltf::Options::DontRequireValidAssetMember;
 
   auto dir = path.parent_path();
 
@@ -81,6 +372,20 @@ static std::optional<fastgltf::Asset> get_asset_from_path(const std::filesystem:
     return std::nullopt; // Failed to load GLTF data
   }
 
+  // The asset views the GLB BIN chunk in place, keep its mapping next to the buffer files
+  data.resolve(asset);
+  if (data.views_file()) {
+    mappings.emplace_back(std::move(*file));
+  }
+
+  if (!map_external_buffers(asset, dir, mappings)) {
+    return std::nullopt;
+  }
+
+  if (!decode_meshopt_buffer_views(asset, decoded)) {
+    return std::nullopt;
+  }
+
   return std::move(asset);
 }
 
@@ -141,257 +446,59 @@ static std::optional<AccessorDescription> get_accessor_by_name(Options options,
   return AccessorDescription(type, get_accessor_from_attribute(asset, *attr));
 }
 
-static void decode_draco_index_buffer(
-    draco::Mesh *mesh, size_t component_size, std::vector<uint8_t> &out_buffer)
-{
-  if (component_size == 4) {
-    ASSERT(sizeof(mesh->face(draco::FaceIndex(0))[0]) == component_size);
-    memcpy(out_buffer.data(), &mesh->face(draco::FaceIndex(0))[0], out_buffer.size());
-  }
-  else {
-    size_t face_stride = component_size * 3;
-    for (draco::FaceIndex f(0); f < mesh->num_faces(); ++f) {
-      const draco::Mesh::Face &face = mesh->face(f);
-      // clang-format off
-      if (component_size == 2) {
-        uint16_t indices[3] = {
-          static_cast<uint16_t>(face[0].value()),
-          static_cast<uint16_t>(face[1].value()),
-          static_cast<uint16_t>(face[2].value())
-        };
-        memcpy(out_buffer.data() + f.value() * face_stride, &indices[0], face_stride);
-      }
-      else {
-        uint8_t indices[3] = {
-          static_cast<uint8_t>(face[0].value()),
-          static_cast<uint8_t>(face[1].value()),
-          static_cast<uint8_t>(face[2].value())
-        };
-        memcpy(out_buffer.data() + f.value() * face_stride, &indices[0], face_stride);
-      }
-      // clang-format on
-    }
-  }
-}
-
-template <typename T>
-static bool get_attribute_for_all_points(
-    draco::Mesh *mesh, const draco::PointAttribute *p_attribute, std::vector<uint8_t> &out_buffer)
-{
-  size_t byte_offset = 0;
-  uint8_t values[64] = {};
-  for (draco::PointIndex i(0); i < mesh->num_points(); ++i) {
-    const draco::AttributeValueIndex val_index = p_attribute->mapped_index(i);
-    if (!p_attribute->ConvertValue<T>(val_index, p_attribute->num_components(), (T *)values)) {
-      return false;
-    }
-
-    ASSERT(byte_offset + sizeof(T) * p_attribute->num_components() <= out_buffer.size());
-    memcpy(out_buffer.data() + byte_offset, &values[0], sizeof(T) * p_attribute->num_components());
-    byte_offset += sizeof(T) * p_attribute->num_components();
-  }
-  return true;
-}
-
-static bool get_attribute_for_all_points(fastgltf::ComponentType component_type,
-    draco::Mesh *mesh,
-    const draco::PointAttribute *p_attribute,
-    std::vector<uint8_t> &out_buffer)
-{
-  bool decode_result = false;
-#if 0
-  switch (component_type) {
-  case fastgltf::ComponentType::UnsignedByte:
-    decode_result =
-        get_attribute_for_all_points<uint8_t>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::Byte:
-    decode_result =
-        get_attribute_for_all_points<int8_t>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::UnsignedShort:
-    decode_result =
-        get_attribute_for_all_points<uint16_t>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::Short:
-    decode_result =
-        get_attribute_for_all_points<int16_t>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::Int:
-    decode_result =
-        get_attribute_for_all_points<int32_t>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::UnsignedInt:
-    decode_result =
-        get_attribute_for_all_points<uint32_t>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::Float:
-    decode_result =
-        get_attribute_for_all_points<float>(mesh, p_attribute, out_buffer);
-    break;
-  case fastgltf::ComponentType::Double:
-    decode_result =
-        get_attribute_for_all_points<double>(mesh, p_attribute, out_buffer);
-    break;
-  default:
-    decode_result = false;
-    break;
-  }
-
-  if (decode_result) {
-    return decode_result;
-  }
-#endif
-
-  switch (p_attribute->data_type()) {
-  case draco::DataType::DT_UINT8:
-    decode_result = get_attribute_for_all_points<uint8_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_INT8:
-    decode_result = get_attribute_for_all_points<int8_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_UINT16:
-    decode_result = get_attribute_for_all_points<uint16_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_INT16:
-    decode_result = get_attribute_for_all_points<int16_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_INT32:
-    decode_result = get_attribute_for_all_points<int32_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_UINT32:
-    decode_result = get_attribute_for_all_points<uint32_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_INT64:
-    decode_result = get_attribute_for_all_points<int64_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_UINT64:
-    decode_result = get_attribute_for_all_points<uint64_t>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_FLOAT32:
-    decode_result = get_attribute_for_all_points<float>(mesh, p_attribute, out_buffer);
-    break;
-  case draco::DataType::DT_FLOAT64:
-    decode_result = get_attribute_for_all_points<double>(mesh, p_attribute, out_buffer);
-    break;
-  default:
-    decode_result = false;
-    break;
-  }
-
-  ASSERT(decode_result, p_attribute->data_type(), component_type);
-  return decode_result;
-}
+/** Points converted per task when a Draco attribute is split across threads. */
+constexpr size_t draco_points_grain = 1 << 14;
 
-// Compute bounding sphere using Ritter's algorithm
-static BoundingSphere calculate_bounding_sphere(const PositionArray &positions)
+/**
+ * Write the first `N` components of `attribute` for every point of `mesh` as floats at
+ * `dst + point * dst_stride`.
+ *
+ * Float attributes are copied, in one block when the layouts already match; other data
+ * types go through Draco's conversion, which applies the attribute's normalization.
+ */
+template <uint32_t N>
+static bool convert_draco_attribute(const draco::Mesh &mesh,
+    const draco::PointAttribute &attribute,
+    std::byte *dst,
+    size_t dst_stride)
 {
-  ZoneScoped;
-
-  if (positions.empty()) {
-    return {mr::Vec3f(0, 0, 0), 0.0f};
-  }
-
-  if (positions.size() == 1) {
-    return BoundingSphere(mr::Vec3f(positions[0][0], positions[0][1], positions[0][2]), 0.0f);
-  }
-
-  // Step 1: Find two most distant points to get initial sphere
-  mr::Vec3f p1(positions[0][0], positions[0][1], positions[0][2]);
-
-  // Find point farthest from p1 - this is forever on sphere bounds
-  mr::Vec3f p2 = p1;
-  float max_dist_sq = 0.0f;
-  for (const auto &pos : positions) {
-    mr::Vec3f p(pos[0], pos[1], pos[2]);
-    float dist_sq = (p - p1).length2();
-    if (dist_sq > max_dist_sq) {
-      max_dist_sq = dist_sq;
-      p2 = p;
-    }
+  constexpr size_t dst_size = N * sizeof(float);
+  const size_t point_count = mesh.num_points();
+  if (attribute.num_components() < N) {
+    return false;
   }
-
-  // Find point farthest from p2 - this is also on sphere bounds, distance will be diameters
-  p1 = p2;
-  max_dist_sq = 0.0f;
-  for (const auto &pos : positions) {
-    mr::Vec3f p(pos[0], pos[1], pos[2]);
-    float dist_sq = (p - p2).length2();
-    if (dist_sq > max_dist_sq) {
-      max_dist_sq = dist_sq;
-      p1 = p;
-    }
+  if (point_count == 0) {
+    return true;
   }
 
-  // Initial sphere from two most distant points
-  mr::Vec3f center = (p1 + p2) * 0.5f;
-  float radius = (p1 - p2).length() * 0.5f;
-
-  float r2 = std::pow(radius, 2);
-  constexpr float eps = 1e-6f;
-  // Step 2: Iteratively expand sphere to include all points
-  for (const auto &pos : positions) {
-    mr::Vec3f point(pos[0], pos[1], pos[2]);
-    mr::Vec3f diff = point - center;
-    float dist2 = diff.length2();
-
-    if (dist2 > r2 + eps) {  // Point is outside (with small epsilon)
-      // Expand sphere to include this point
-      // New radius is midpoint between old radius and distance to point
-      float dist = std::sqrt(dist2);
-      float new_radius = (radius + dist) * 0.5f;
-
-      // Move center along direction to point
-      float alpha = (new_radius - radius) / dist;
-      center = center + diff * alpha;
-      radius = new_radius;
-      r2 = std::pow(radius, 2);
-    }
+  const bool is_float = attribute.data_type() == draco::DataType::DT_FLOAT32;
+  if (is_float && attribute.is_mapping_identity() && attribute.byte_stride() == dst_size &&
+      dst_stride == dst_size) {
+    std::memcpy(dst, attribute.GetAddress(draco::AttributeValueIndex(0)), point_count * dst_size);
+    return true;
   }
 
-  return BoundingSphere(center, radius);
-}
-
-static size_t byte_size(fastgltf::ComponentType component_type)
-{
-  switch (component_type) {
-  case fastgltf::ComponentType::Byte:
-  case fastgltf::ComponentType::UnsignedByte:
-    return 1;
-  case fastgltf::ComponentType::Short:
-  case fastgltf::ComponentType::UnsignedShort:
-    return 2;
-  case fastgltf::ComponentType::Int:
-  case fastgltf::ComponentType::UnsignedInt:
-  case fastgltf::ComponentType::Float:
-    return 4;
-  case fastgltf::ComponentType::Double:
-    return 8;
-  default:
-    return 0;
-  }
-}
+  std::atomic_bool error = false;
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, point_count, draco_points_grain),
+      [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+          const draco::AttributeValueIndex value =
+              attribute.mapped_index(draco::PointIndex(static_cast<uint32_t>(i)));
+          std::byte *out = dst + i * dst_stride;
+          if (is_float) {
+            std::memcpy(out, attribute.GetAddress(value), dst_size);
+            continue;
+          }
 
-static size_t byte_size(draco::DataType component_type)
-{
-  switch (component_type) {
-  case draco::DataType::DT_UINT8:
-  case draco::DataType::DT_INT8:
-    return 1;
-  case draco::DataType::DT_UINT16:
-  case draco::DataType::DT_INT16:
-    return 2;
-  case draco::DataType::DT_UINT32:
-  case draco::DataType::DT_INT32:
-  case draco::DataType::DT_FLOAT32:
-    return 4;
-  case draco::DataType::DT_UINT64:
-  case draco::DataType::DT_INT64:
-  case draco::DataType::DT_FLOAT64:
-    return 8;
-  default:
-    return 0;
-  }
+          float converted[N];
+          if (!attribute.ConvertValue<float>(value, N, converted)) {
+            error = true;
+            return;
+          }
+          std::memcpy(out, converted, dst_size);
+        }
+      });
+  return !error;
 }
 
 // Main Draco decoding function
@@ -411,76 +518,50 @@ static bool decode_draco_primitive(mr::Options options,
   auto &buffer = asset.buffers[buffer_view.bufferIndex];
 
   // Extract Draco compressed data
-  std::span<const char> draco_data;
-  std::visit(
-      fastgltf::visitor{[&](const fastgltf::sources::Array &array) {
-                          draco_data = {(const char *)array.bytes.data() + buffer_view.byteOffset,
-                              buffer_view.byteLength};
-                        },
-          [&](const fastgltf::sources::Vector &vector) {
-            draco_data = {
-                (const char *)vector.bytes.data() + buffer_view.byteOffset, buffer_view.byteLength};
-          },
-          [](auto &arg) {
-            DEBUG_ASSERT(false, "Unsupported buffer source for Draco compression", arg);
-          }},
-      buffer.data);
+  const std::span<const std::byte> draco_data =
+      get_buffer_bytes(buffer).subspan(buffer_view.byteOffset, buffer_view.byteLength);
 
   // Decode Draco mesh
   draco::Decoder decoder;
   draco::DecoderBuffer decoder_buffer;
-  decoder_buffer.Init(draco_data.data(), draco_data.size());
+  decoder_buffer.Init((const char *)draco_data.data(), draco_data.size());
   auto decode_result = decoder.DecodeMeshFromBuffer(&decoder_buffer);
   if (!decode_result.ok()) {
-    MR_ERROR("Failed to decode Draco mesh:", decode_result.status().error_msg_string());
+    MR_ERROR("Failed to decode Draco mesh: {}", decode_result.status().error_msg_string());
     return false;
   }
 
   const std::unique_ptr<draco::Mesh> mesh = std::move(decode_result).value();
 
-  // Process indices
+  // Draco stores faces as contiguous 32-bit point indices, the same layout as IndexArray
+  static_assert(sizeof(draco::Mesh::Face) == 3 * sizeof(Index));
   if (primitive.indicesAccessor.has_value()) {
-    auto &indices_accessor = asset.accessors[primitive.indicesAccessor.value()];
-    size_t component_size = std::max<size_t>(byte_size(indices_accessor.componentType),
-        1 + (mesh->num_points() > UINT8_MAX) + ((mesh->num_points() > UINT16_MAX) << 1));
-
-    std::vector<uint8_t> index_buffer(mesh->num_faces() * 3 * component_size);
-    decode_draco_index_buffer(mesh.get(), component_size, index_buffer);
-
-    // Convert to uint32_t indices for our mesh format
     out_indices.resize(mesh->num_faces() * 3);
-    if (component_size == 1) {
-      const uint8_t *src = reinterpret_cast<const uint8_t *>(index_buffer.data());
-      for (size_t i = 0; i < out_indices.size(); ++i) {
-        out_indices[i] = src[i];
-      }
-    }
-    else if (component_size == 2) {
-      const uint16_t *src = reinterpret_cast<const uint16_t *>(index_buffer.data());
-      for (size_t i = 0; i < out_indices.size(); ++i) {
-        out_indices[i] = src[i];
-      }
-    }
-    else {
-      const uint32_t *src = reinterpret_cast<const uint32_t *>(index_buffer.data());
-      for (size_t i = 0; i < out_indices.size(); ++i) {
-        out_indices[i] = src[i];
-      }
-    }
   }
 
   // Process attributes
   out_positions.resize(mesh->num_points());
-  if (is_enabled(options, mr::Options::LoadMeshAttributes)) {
+  const bool load_attributes = is_enabled(options, mr::Options::LoadMeshAttributes);
+  if (load_attributes) {
     out_attributes.resize(mesh->num_points());
   }
+  std::byte *attributes_data = reinterpret_cast<std::byte *>(out_attributes.data());
+
+  struct DracoTarget {
+    const draco::PointAttribute *attribute;
+    uint32_t components;
+    std::byte *dst;
+    size_t dst_stride;
+    std::string_view name;
+  };
+  std::vector<DracoTarget> targets;
 
   for (const auto &[attribute_name, draco_attribute_id] : primitive.dracoCompression->attributes) {
     if (attribute_name.empty()) {
       continue;
     }
 
-    if (attribute_name != "POSITION" && is_disabled(options, mr::Options::LoadMeshAttributes)) {
+    if (attribute_name != "POSITION" && !load_attributes) {
       continue;
     }
 
@@ -488,49 +569,58 @@ static bool decode_draco_primitive(mr::Options options,
     if (!draco_attr)
       continue;
 
-    // Get the original accessor to determine component type
-    fastgltf::ComponentType component_type = fastgltf::ComponentType::Float; // default
-    auto attr_accessor = primitive.dracoCompression->findAttribute(attribute_name);
-    if (attr_accessor == nullptr) {
-      continue;
-    }
-    auto &accessor = asset.accessors[attr_accessor->accessorIndex];
-    component_type = accessor.componentType;
-
-    std::vector<uint8_t> attr_buffer;
-    attr_buffer.resize(mesh->num_points() * draco_attr->num_components() *
-                       std::max(byte_size(component_type), byte_size(draco_attr->data_type())));
-
-    if (!get_attribute_for_all_points(component_type, mesh.get(), draco_attr, attr_buffer)) {
-      MR_ERROR("Failed to decode Draco attribute:", attribute_name);
-      continue;
-    }
-
-    // Convert to our internal format
     if (attribute_name == "POSITION") {
-      const float *src = reinterpret_cast<const float *>(attr_buffer.data());
-      for (size_t i = 0; i < mesh->num_points(); ++i) {
-        out_positions[i] = {src[i * 3], src[i * 3 + 1], src[i * 3 + 2]};
-      }
+      targets.push_back({draco_attr,
+          3,
+          reinterpret_cast<std::byte *>(out_positions.data()),
+          sizeof(Position),
+          attribute_name});
     }
     else if (attribute_name == "NORMAL") {
-      const float *src = reinterpret_cast<const float *>(attr_buffer.data());
-      for (size_t i = 0; i < mesh->num_points(); ++i) {
-        out_attributes[i].normal = {src[i * 3], src[i * 3 + 1], src[i * 3 + 2]};
-      }
+      out_attributes.is_normal_present = true;
+      targets.push_back({draco_attr,
+          3,
+          attributes_data + offsetof(VertexAttributes, normal),
+          sizeof(VertexAttributes),
+          attribute_name});
     }
     else if (attribute_name == "TEXCOORD_0") {
-      const float *src = reinterpret_cast<const float *>(attr_buffer.data());
-      for (size_t i = 0; i < mesh->num_points(); ++i) {
-        out_attributes[i].texcoord = {src[i * 2], src[i * 2 + 1]};
-      }
+      out_attributes.is_texcoord_present = true;
+      targets.push_back({draco_attr,
+          2,
+          attributes_data + offsetof(VertexAttributes, texcoord),
+          sizeof(VertexAttributes),
+          attribute_name});
     }
     else {
       DEBUG_ASSERT(false, "Unhandled attribute", attribute_name);
     }
   }
 
-  return true;
+  // Attributes write disjoint fields, so they convert concurrently next to the index copy
+  tbb::task_group group;
+  if (!out_indices.empty()) {
+    group.run([&]() {
+      std::memcpy(out_indices.data(),
+          &mesh->face(draco::FaceIndex(0))[0],
+          out_indices.size() * sizeof(Index));
+    });
+  }
+  std::atomic_bool error = false;
+  for (const DracoTarget &target : targets) {
+    group.run([&mesh, &target, &error]() {
+      const bool converted = target.components == 3
+          ? convert_draco_attribute<3>(*mesh, *target.attribute, target.dst, target.dst_stride)
+          : convert_draco_attribute<2>(*mesh, *target.attribute, target.dst, target.dst_stride);
+      if (!converted) {
+        MR_ERROR("Failed to decode Draco attribute: {}", target.name);
+        error = true;
+      }
+    });
+  }
+  group.wait();
+
+  return !error;
 }
 /**
  * Convert a glTF primitive into an internal Mesh.
@@ -555,26 +645,7 @@ static std::optional<Mesh> get_mesh_from_primitive(
         IndexSpan() // empty shadow indices
     );
 
-    tbb::parallel_invoke(
-    [&]() {
-      if (!mesh.positions.empty()) {
-        auto min_pos = mesh.positions[0];
-        auto max_pos = mesh.positions[0];
-        for (const auto &pos : mesh.positions) {
-          min_pos[0] = std::min(min_pos[0], pos[0]);
-          min_pos[1] = std::min(min_pos[1], pos[1]);
-          min_pos[2] = std::min(min_pos[2], pos[2]);
-          max_pos[0] = std::max(max_pos[0], pos[0]);
-          max_pos[1] = std::max(max_pos[1], pos[1]);
-          max_pos[2] = std::max(max_pos[2], pos[2]);
-        }
-        mesh.aabb.min = {min_pos[0], min_pos[1], min_pos[2]};
-        mesh.aabb.max = {max_pos[0], max_pos[1], max_pos[2]};
-      }
-    },
-    [&]() {
-      mesh.bounding_sphere = calculate_bounding_sphere(mesh.positions);
-    });
+    update_mesh_bounds(mesh);
 
     // Set material
     if (primitive.materialIndex) {
@@ -590,84 +661,156 @@ static std::optional<Mesh> get_mesh_from_primitive(
 
     return mesh;
   }
+  else if (primitive.dracoCompression) {
+    // Draco accessors carry no buffer views, so there is nothing to fall back to
+    return std::nullopt;
+  }
   else {
+    std::optional<AccessorDescription> positions =
+        get_accessor_by_name(options, asset, primitive, "POSITION");
+    if (!positions.has_value()) {
+      MR_ERROR("Primitive didn't contain positions");
+      return std::nullopt;
+    }
+    if (positions.value().accessor.type != fastgltf::AccessorType::Vec3) {
+      MR_ERROR("Positions are not in vec3 format ({})",
+          getAccessorTypeName(positions.value().accessor.type));
+      return std::nullopt;
+    }
+
+    const bool load_attributes = is_enabled(options, Options::LoadMeshAttributes);
+    const std::optional<AccessorDescription> normals =
+        load_attributes ? get_accessor_by_name(options, asset, primitive, "NORMAL") : std::nullopt;
+    const std::optional<AccessorDescription> texcoords = load_attributes
+        ? get_accessor_by_name(options, asset, primitive, "TEXCOORD_0")
+        : std::nullopt;
+
+    const size_t vertex_count = positions.value().accessor.count;
+    if ((normals.has_value() && normals.value().accessor.count != vertex_count) ||
+        (texcoords.has_value() && texcoords.value().accessor.count != vertex_count)) {
+      MR_ERROR("Vertex attribute count doesn't match position count");
+      return std::nullopt;
+    }
+
+    // Quantized positions stay compact, and so do the attributes quantized next to them
+    const bool quantized = is_enabled(options, Options::KeepQuantizedVertices) &&
+        is_quantized_component(positions.value().accessor.componentType);
+    const bool quantized_normals = quantized && normals.has_value() &&
+        is_quantized_component(normals.value().accessor.componentType);
+    const bool quantized_texcoords = quantized && texcoords.has_value() &&
+        is_quantized_component(texcoords.value().accessor.componentType);
+
+    // Size every destination up front so the conversions below write in place, in parallel
+    if (quantized) {
+      mesh.quantized.positions.resize(vertex_count);
+    }
+    else {
+      mesh.positions.resize(vertex_count);
+    }
+    if (quantized_normals) {
+      mesh.quantized.normals.resize(vertex_count);
+    }
+    if (quantized_texcoords) {
+      mesh.quantized.texcoords.resize(vertex_count);
+    }
+    if ((normals.has_value() && !quantized_normals) ||
+        (texcoords.has_value() && !quantized_texcoords)) {
+      mesh.attributes.resize(vertex_count);
+      // Quantized attributes live in `mesh.quantized`, the slots here stay zero
+      mesh.attributes.is_normal_present = normals.has_value() && !quantized_normals;
+      mesh.attributes.is_texcoord_present = texcoords.has_value() && !quantized_texcoords;
+    }
+    std::byte *attributes_data = reinterpret_cast<std::byte *>(mesh.attributes.data());
+    using Quantized3 = QuantizedVertexArray::Quantized3;
+    using Quantized2 = QuantizedVertexArray::Quantized2;
+
     std::atomic_bool error = false;
-    std::mutex attributes_resize_mutex;
     tbb::parallel_invoke(
         [&]() {
-          std::optional<AccessorDescription> positions =
-              get_accessor_by_name(options, asset, primitive, "POSITION");
-          if (!positions.has_value() ||
-              positions.value().accessor.type != fastgltf::AccessorType::Vec3) {
-            MR_ERROR("Positions are not in vec3 format ({})",
-                getAccessorTypeName(positions.value().accessor.type));
+          if (quantized) {
+            const std::optional<QuantizedVertexArray::Decode> decode =
+                copy_quantized_accessor(asset,
+                    positions.value().accessor,
+                    3,
+                    reinterpret_cast<std::byte *>(mesh.quantized.positions.data()),
+                    sizeof(Quantized3));
+            if (!decode.has_value()) {
+              MR_ERROR("Unsupported quantized position data");
+              error = true;
+              return;
+            }
+            mesh.quantized.position_decode = *decode;
+          }
+          else if (!convert_accessor(asset,
+                       positions.value().accessor,
+                       3,
+                       reinterpret_cast<std::byte *>(mesh.positions.data()),
+                       sizeof(Position))) {
+            MR_ERROR("Unsupported position component type");
             error = true;
             return;
           }
-          mesh.positions.reserve(positions.value().accessor.count);
-          fastgltf::iterateAccessor<glm::vec3>(asset, positions.value().accessor, [&](glm::vec3 v) {
-            mesh.positions.push_back({v.x, v.y, v.z});
-          });
 
-          // Calculate bounds
-          tbb::parallel_invoke(
-          [&]() {
-            auto min_pos = mesh.positions[0];
-            auto max_pos = mesh.positions[0];
-            for (const auto &pos : mesh.positions) {
-              min_pos[0] = std::min(min_pos[0], pos[0]);
-              min_pos[1] = std::min(min_pos[1], pos[1]);
-              min_pos[2] = std::min(min_pos[2], pos[2]);
-              max_pos[0] = std::max(max_pos[0], pos[0]);
-              max_pos[1] = std::max(max_pos[1], pos[1]);
-              max_pos[2] = std::max(max_pos[2], pos[2]);
-            }
-            mesh.aabb.min = {min_pos[0], min_pos[1], min_pos[2]};
-            mesh.aabb.max = {max_pos[0], max_pos[1], max_pos[2]};
-          },
-          [&]() {
-            mesh.bounding_sphere = calculate_bounding_sphere(mesh.positions);
-          });
+          update_mesh_bounds(mesh);
         },
         [&]() {
-          if (is_disabled(options, Options::LoadMeshAttributes)) {
+          if (!normals.has_value()) {
             return;
           }
 
-          std::optional<AccessorDescription> normals =
-              get_accessor_by_name(options, asset, primitive, "NORMAL");
-          if (normals.has_value()) {
-            mesh.attributes.is_normal_present = true;
-            int count = normals.value().accessor.count;
-            {
-              std::lock_guard lock(attributes_resize_mutex);
-              mesh.attributes.resize(count);
+          ASSERT(normals.value().accessor.type == fastgltf::AccessorType::Vec3,
+              "Normals are not in vec3 format",
+              getAccessorTypeName(normals.value().accessor.type));
+          if (quantized_normals) {
+            const std::optional<QuantizedVertexArray::Decode> decode =
+                copy_quantized_accessor(asset,
+                    normals.value().accessor,
+                    3,
+                    reinterpret_cast<std::byte *>(mesh.quantized.normals.data()),
+                    sizeof(Quantized3));
+            if (!decode.has_value()) {
+              MR_ERROR("Unsupported quantized normal data");
+              error = true;
+              return;
             }
-            ASSERT(normals.value().accessor.type == fastgltf::AccessorType::Vec3,
-                "Normals are not in vec3 format",
-                getAccessorTypeName(normals.value().accessor.type));
-            fastgltf::iterateAccessorWithIndex<glm::vec3>(asset,
-                normals.value().accessor,
-                [&](glm::vec3 v, int index) { mesh.attributes[index].normal = {v.x, v.y, v.z}; });
+            mesh.quantized.normal_decode = *decode;
+          }
+          else if (!convert_accessor(asset,
+                  normals.value().accessor,
+                  3,
+                  attributes_data + offsetof(VertexAttributes, normal),
+                  sizeof(VertexAttributes))) {
+            MR_ERROR("Unsupported normal component type");
+            error = true;
           }
         },
         [&]() {
-          if (is_disabled(options, Options::LoadMeshAttributes)) {
+          if (!texcoords.has_value()) {
             return;
           }
 
-          std::optional<AccessorDescription> texcoords =
-              get_accessor_by_name(options, asset, primitive, "TEXCOORD_0");
-          if (texcoords.has_value()) {
-            mesh.attributes.is_texcoord_present = true;
-            ASSERT(texcoords.value().accessor.type == fastgltf::AccessorType::Vec2);
-            {
-              std::lock_guard lock(attributes_resize_mutex);
-              mesh.attributes.resize(texcoords.value().accessor.count);
+          ASSERT(texcoords.value().accessor.type == fastgltf::AccessorType::Vec2);
+          if (quantized_texcoords) {
+            const std::optional<QuantizedVertexArray::Decode> decode =
+                copy_quantized_accessor(asset,
+                    texcoords.value().accessor,
+                    2,
+                    reinterpret_cast<std::byte *>(mesh.quantized.texcoords.data()),
+                    sizeof(Quantized2));
+            if (!decode.has_value()) {
+              MR_ERROR("Unsupported quantized texture coordinate data");
+              error = true;
+              return;
             }
-            fastgltf::iterateAccessorWithIndex<glm::vec2>(asset,
-                texcoords.value().accessor,
-                [&](glm::vec2 v, int index) { mesh.attributes[index].texcoord = {v.x, v.y}; });
+            mesh.quantized.texcoord_decode = *decode;
+          }
+          else if (!convert_accessor(asset,
+                  texcoords.value().accessor,
+                  2,
+                  attributes_data + offsetof(VertexAttributes, texcoord),
+                  sizeof(VertexAttributes))) {
+            MR_ERROR("Unsupported texture coordinate component type");
+            error = true;
           }
         },
         [&]() {
@@ -679,7 +822,11 @@ static std::optional<Mesh> get_mesh_from_primitive(
 
           auto &idxAccessor = asset.accessors[primitive.indicesAccessor.value()];
           mesh.indices.resize(idxAccessor.count);
-          fastgltf::copyFromAccessor<std::uint32_t>(asset, idxAccessor, mesh.indices.data());
+          if (!convert_index_accessor(asset, idxAccessor, mesh.indices.data())) {
+            MR_ERROR("Unsupported index component type");
+            error = true;
+            return;
+          }
 
           ASSERT(mesh.lods.size() == 0);
           mesh.lods.emplace_back(IndexSpan(mesh.indices.data(), mesh.indices.size()), IndexSpan());
@@ -698,18 +845,151 @@ static std::optional<Mesh> get_mesh_from_primitive(
     }
   }
 
-  if (mesh.attributes.size() != 0 && mesh.positions.size() != mesh.attributes.size()) {
+  const size_t vertex_count =
+      mesh.quantized.empty() ? mesh.positions.size() : mesh.quantized.positions.size();
+  if (mesh.attributes.size() != 0 && vertex_count != mesh.attributes.size()) {
     return std::nullopt;
   }
 
   return mesh;
 }
 
+/** Top three rows of a column-major glTF matrix. */
+static AffineTransform affine_from_gltf_matrix(const fastgltf::math::fmat4x4 &matrix)
+{
+  AffineTransform result;
+  for (int row = 0; row < 3; row++) {
+    for (int column = 0; column < 4; column++) {
+      result.rows[row][column] = matrix[column][row];
+    }
+  }
+  return result;
+}
+
+/** Instances per task when expanding EXT_mesh_gpu_instancing attributes. */
+constexpr size_t instance_grain = 1 << 12;
+
+/**
+ * Expand the EXT_mesh_gpu_instancing TRS attributes of `node` into `parent * T * R * S`
+ * and append them to `out`.
+ *
+ * The attributes are converted in bulk (including normalized integer rotations) and the
+ * 3x4 products are built directly from the quaternion, in parallel over instances.
+ * Missing attributes default to identity.
+ */
+static void append_instance_transforms(const fastgltf::Asset &asset,
+    const fastgltf::Node &node,
+    const fastgltf::math::fmat4x4 &parent,
+    TransformArray::Table &out)
+{
+  ZoneScoped;
+
+  const auto find_accessor = [&](std::string_view name) -> const fastgltf::Accessor * {
+    const auto attribute = node.findInstancingAttribute(name);
+    if (attribute == node.instancingAttributes.cend()) {
+      return nullptr;
+    }
+    return &get_accessor_from_attribute(asset, *attribute);
+  };
+  const fastgltf::Accessor *translation_accessor = find_accessor("TRANSLATION");
+  const fastgltf::Accessor *rotation_accessor = find_accessor("ROTATION");
+  const fastgltf::Accessor *scale_accessor = find_accessor("SCALE");
+
+  size_t count = std::numeric_limits<size_t>::max();
+  for (const fastgltf::Accessor *accessor :
+      {translation_accessor, rotation_accessor, scale_accessor}) {
+    if (accessor != nullptr) {
+      count = std::min<size_t>(count, accessor->count);
+    }
+  }
+  if (count == std::numeric_limits<size_t>::max() || count == 0) {
+    return;
+  }
+
+  std::vector<std::array<float, 3>> translations(count, {0, 0, 0});
+  std::vector<std::array<float, 4>> rotations(count, {0, 0, 0, 1});
+  std::vector<std::array<float, 3>> scales(count, {1, 1, 1});
+  const auto convert = [&](const fastgltf::Accessor *accessor, uint32_t components, auto &dst) {
+    if (accessor != nullptr && accessor->count == count &&
+        !convert_accessor(asset,
+            *accessor,
+            components,
+            reinterpret_cast<std::byte *>(dst.data()),
+            sizeof(dst[0]))) {
+      MR_ERROR("Unsupported instancing attribute component type");
+    }
+  };
+  tbb::parallel_invoke([&]() { convert(translation_accessor, 3, translations); },
+      [&]() { convert(rotation_accessor, 4, rotations); },
+      [&]() { convert(scale_accessor, 3, scales); });
+
+  // Parent rows, glTF matrices are column-major
+  float p[3][4];
+  for (int row = 0; row < 3; row++) {
+    for (int column = 0; column < 4; column++) {
+      p[row][column] = parent[column][row];
+    }
+  }
+
+  const size_t first = out.size();
+  out.resize(first + count);
+  AffineTransform *dst = out.data() + first;
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count, instance_grain),
+      [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+          const auto [x, y, z, w] = rotations[i];
+          const std::array<float, 3> &s = scales[i];
+          const std::array<float, 3> &t = translations[i];
+
+          const float xx = x * x, yy = y * y, zz = z * z;
+          const float xy = x * y, xz = x * z, yz = y * z;
+          const float wx = w * x, wy = w * y, wz = w * z;
+
+          // Local T * R * S with the scale folded into the rotation columns
+          // clang-format off
+          const float local[3][4] = {
+            {(1 - 2 * (yy + zz)) * s[0], 2 * (xy - wz) * s[1], 2 * (xz + wy) * s[2], t[0]},
+            {2 * (xy + wz) * s[0], (1 - 2 * (xx + zz)) * s[1], 2 * (yz - wx) * s[2], t[1]},
+            {2 * (xz - wy) * s[0], 2 * (yz + wx) * s[1], (1 - 2 * (xx + yy)) * s[2], t[2]},
+          };
+          // clang-format on
+
+          AffineTransform &result = dst[i];
+          for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 4; column++) {
+              result.rows[row][column] = p[row][0] * local[0][column] +
+                                         p[row][1] * local[1][column] +
+                                         p[row][2] * local[2][column];
+            }
+            result.rows[row][3] += p[row][3];
+          }
+        }
+      });
+}
+
+/**
+ * Relative cost of converting a primitive: its vertex count plus its index count.
+ * Used only to order the work, so Draco and sparse primitives use the declared counts.
+ */
+static size_t get_primitive_cost(const fastgltf::Asset &asset, const fastgltf::Primitive &primitive)
+{
+  size_t cost = 0;
+  if (const auto *position = primitive.findAttribute("POSITION");
+      position != primitive.attributes.cend()) {
+    cost += get_accessor_from_attribute(asset, *position).count;
+  }
+  if (primitive.indicesAccessor.has_value()) {
+    cost += asset.accessors[*primitive.indicesAccessor].count;
+  }
+  return cost;
+}
+
 /**
  * Extract meshes from the fastgltf asset and attach per-mesh transforms.
  *
  * Iterates scene nodes to gather transforms, then converts all primitives
- * into Mesh objects, preserving names.
+ * into Mesh objects, preserving names. Primitives of one glTF mesh share
+ * its transform table.
  */
 static std::vector<Mesh> get_meshes_from_asset(Options options, fastgltf::Asset *asset)
 {
@@ -719,7 +999,7 @@ static std::vector<Mesh> get_meshes_from_asset(Options options, fastgltf::Asset
 
   using namespace fastgltf;
 
-  std::vector<std::vector<Transform>> transforms;
+  std::vector<TransformArray::Table> transforms;
   transforms.resize(asset->meshes.size());
   {
     ZoneScoped;
@@ -729,90 +1009,82 @@ static std::vector<Mesh> get_meshes_from_asset(Options options, fastgltf::Asset
         fastgltf::math::fmat4x4(),
         [&](fastgltf::Node &node, fastgltf::math::fmat4x4 matrix) {
           if (node.meshIndex.has_value()) {
+            TransformArray::Table &mesh_transforms = transforms[*node.meshIndex];
             if (node.instancingAttributes.size() > 0) {
-              std::vector<fastgltf::math::fvec3> translations;
-              const auto &translation_iterator = node.findInstancingAttribute("TRANSLATION");
-              ASSERT(translation_iterator != node.instancingAttributes.cend());
-              const auto &translation_accessor =
-                  get_accessor_from_attribute(*asset, *translation_iterator);
-              translations.reserve(translation_accessor.count);
-              fastgltf::iterateAccessor<fastgltf::math::fvec3>(*asset,
-                  translation_accessor,
-                  [&](fastgltf::math::fvec3 v) { translations.push_back({v.x(), v.y(), v.z()}); });
-
-              std::vector<fastgltf::math::fquat> rotations;
-              const auto &rotation_iterator = node.findInstancingAttribute("ROTATION");
-              ASSERT(rotation_iterator != node.instancingAttributes.cend());
-              const auto &rotation_accessor =
-                  get_accessor_from_attribute(*asset, *rotation_iterator);
-              rotations.reserve(translation_accessor.count);
-              fastgltf::iterateAccessor<fastgltf::math::fquat>(*asset,
-                  rotation_accessor,
-                  [&](fastgltf::math::fquat q) { rotations.push_back(q); });
-
-              std::vector<fastgltf::math::fvec3> scales;
-              const auto &scale_iterator = node.findInstancingAttribute("SCALE");
-              ASSERT(scale_iterator != node.instancingAttributes.cend());
-              const auto &scale_accessor = get_accessor_from_attribute(*asset, *scale_iterator);
-              scales.reserve(scale_accessor.count);
-              fastgltf::iterateAccessor<fastgltf::math::fvec3>(*asset,
-                  scale_accessor,
-                  [&](fastgltf::math::fvec3 v) { scales.push_back({v.x(), v.y(), v.z()}); });
-
-              transforms[*node.meshIndex].reserve(scales.size());
-              for (const auto &[t, r, s] : std::views::zip(translations, rotations, scales)) {
-                fastgltf::math::fmat4x4 res = scale(rotate(translate(matrix, t), r), s);
-                // clang-format off
-                transforms[*node.meshIndex].push_back({
-                    res[0][0], res[1][0], res[2][0], res[3][0],
-                    res[0][1], res[1][1], res[2][1], res[3][1],
-                    res[0][2], res[1][2], res[2][2], res[3][2],
-                    res[0][3], res[1][3], res[2][3], res[3][3],
-                });
-                // clang-format on
-              }
+              append_instance_transforms(*asset, node, matrix, mesh_transforms);
             }
 
-            glm::mat4 t = glm::make_mat4(matrix.data());
-            // clang-format off
-            transforms[*node.meshIndex].push_back({
-                t[0][0], t[1][0], t[2][0], t[3][0],
-                t[0][1], t[1][1], t[2][1], t[3][1],
-                t[0][2], t[1][2], t[2][2], t[3][2],
-                t[0][3], t[1][3], t[2][3], t[3][3],
-            });
-            // clang-format on
+            mesh_transforms.push_back(affine_from_gltf_matrix(matrix));
           }
         });
   }
 
-  tbb::concurrent_vector<Mesh> meshes;
-  meshes.reserve(asset->meshes.size() * 2);
+  // Every primitive of a mesh references the same table instead of copying it
+  std::vector<TransformArray> shared_transforms;
+  shared_transforms.reserve(transforms.size());
+  for (TransformArray::Table &mesh_transforms : transforms) {
+    shared_transforms.emplace_back(std::move(mesh_transforms));
+  }
+
+  // One work item per primitive, in mesh then primitive order, which is also the output order
+  struct PrimitiveWork {
+    size_t mesh;
+    size_t primitive;
+    size_t cost;
+  };
+  std::vector<PrimitiveWork> work;
+  for (size_t i = 0; i < asset->meshes.size(); i++) {
+    const fastgltf::Mesh &gltfMesh = asset->meshes[i];
+    for (size_t j = 0; j < gltfMesh.primitives.size(); j++) {
+      work.push_back({i, j, get_primitive_cost(*asset, gltfMesh.primitives[j])});
+    }
+  }
+
+  // Start the heaviest primitives first so one huge mesh doesn't become the tail of the load
+  std::vector<size_t> schedule(work.size());
+  std::iota(schedule.begin(), schedule.end(), size_t(0));
+  std::stable_sort(schedule.begin(), schedule.end(), [&work](size_t a, size_t b) {
+    return work[a].cost > work[b].cost;
+  });
 
+  std::vector<std::optional<Mesh>> slots(work.size());
   {
     ZoneScoped;
 
-    tbb::parallel_for<int>(0, asset->meshes.size(), [&](int i) {
-      const fastgltf::Mesh &gltfMesh = asset->meshes[i];
-      tbb::parallel_for<int>(0, gltfMesh.primitives.size(), [&](int j) {
-        const auto &primitive = gltfMesh.primitives[j];
-        std::optional<Mesh> mesh_opt = get_mesh_from_primitive(options, *asset, primitive);
-        if (mesh_opt.has_value()) {
-          mesh_opt->transforms = transforms[i];
-          mesh_opt->name = std::move(gltfMesh.name);
-          meshes.emplace_back(std::move(mesh_opt.value()));
-        }
-      });
-    });
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, schedule.size(), 1),
+        [&](const tbb::blocked_range<size_t> &range) {
+          for (size_t k = range.begin(); k < range.end(); k++) {
+            const PrimitiveWork &item = work[schedule[k]];
+            const fastgltf::Mesh &gltfMesh = asset->meshes[item.mesh];
+            std::optional<Mesh> &mesh_opt = slots[schedule[k]];
+            mesh_opt =
+                get_mesh_from_primitive(options, *asset, gltfMesh.primitives[item.primitive]);
+            if (mesh_opt.has_value()) {
+              mesh_opt->transforms = shared_transforms[item.mesh];
+              mesh_opt->name = gltfMesh.name;
+            }
+          }
+        },
+        tbb::simple_partitioner());
   }
 
   std::vector<Mesh> result;
-  result.resize(meshes.size());
-  tbb::parallel_for<int>(0, meshes.size(), [&](int i) { result[i] = std::move(meshes[i]); });
+  result.reserve(slots.size());
+  for (std::optional<Mesh> &mesh_opt : slots) {
+    if (mesh_opt.has_value()) {
+      result.emplace_back(std::move(mesh_opt.value()));
+    }
+  }
 
   return result;
 }
 
+/**
+ * Widen every pixel of the image (all mips) to `desired_component_number` components.
+ *
+ * New components are zero except alpha, which becomes opaque.
+ */
 static void resize_image(ImageData &image,
     size_t component_number,
     size_t component_size,
@@ -824,323 +1096,335 @@ static void resize_image(ImageData &image,
     return;
   }
 
-  size_t pixel_size = image.pixel_byte_size();
-  size_t pixel_count = image.num_of_pixels();
+  const ChannelExpansion expansion{
+      .src_components = static_cast<uint32_t>(component_number),
+      .dst_components = static_cast<uint32_t>(desired_component_number),
+      .component_size = static_cast<uint32_t>(component_size),
+  };
+  const size_t pixel_size = expansion.src_pixel_size();
+  const size_t desired_pixel_size = expansion.dst_pixel_size();
+  const size_t pixel_count = image.pixels.size() / pixel_size;
 
-  size_t desired_pixel_size = desired_component_number * component_size;
+  const size_t desired_byte_size = pixel_count * desired_pixel_size;
+  auto new_ptr = std::make_unique_for_overwrite<std::byte[]>(desired_byte_size);
 
-  size_t desired_byte_size = pixel_size * pixel_count / component_number * desired_component_number;
-  std::unique_ptr<std::byte[]> new_ptr = std::make_unique<std::byte[]>(desired_byte_size);
+  expand_channels(image.pixels.get(), new_ptr.get(), pixel_count, expansion);
 
-  for (int i = 0; i < pixel_count; i++) {
-    size_t pixel_byte_offset = i * pixel_size;
-    size_t desired_pixel_byte_offset = i * desired_pixel_size;
-    for (int j = 0; j < std::min(component_number, desired_component_number); j++) {
-      for (int k = 0; k < component_size; k++) {
-        new_ptr[desired_pixel_byte_offset + j * component_size + k] =
-            image.pixels[pixel_byte_offset + j * component_size + k];
-      }
-    }
+  for (auto &mip : image.mips) {
+    size_t offset = (mip.data() - image.pixels.get()) / pixel_size * desired_pixel_size;
+    size_t desired_mip_size = mip.size() / pixel_size * desired_pixel_size;
+    mip = {new_ptr.get() + offset, desired_mip_size};
   }
 
   image.pixels = std::move(new_ptr);
   image.pixels.size(desired_byte_size);
-
-  int offset = 0;
-  for (int i = 0; i < image.mips.size(); i++) {
-    size_t desired_mip_size = image.mips[i].size() / component_number * desired_component_number;
-    image.mips[i] = {image.pixels.get() + offset, desired_mip_size};
-    offset += desired_mip_size;
-  }
+  image.bytes_per_pixel = desired_pixel_size;
 }
 
-/**
- * Decode a glTF image.
- *
- * Supports URI, embedded vector, and buffer view sources. Returns an
- * ImageData with owned memory; logs warnings for unexpected sources.
- */
-static std::optional<ImageData> get_image_from_gltf(const std::filesystem::path &directory,
-    Options options,
-    const fastgltf::Asset &asset,
-    const fastgltf::Image &image)
-{
-  ZoneScoped;
-
-  ImageData new_image{};
+/** Mips at or below this extent are loaded eagerly with \ref Options::StreamTextureMips. */
+constexpr uint32_t streaming_mip_tail_extent = 256;
 
-  auto load_dds_from_file = [](const std::string &path, ImageData &new_image) -> bool {
-    ZoneScopedN("DDS import from file");
+/** Mips [first, first + count) of a texture chain, `count` is clamped to the existing ones. */
+struct MipRange {
+  uint32_t first = 0;
+  uint32_t count = std::numeric_limits<uint32_t>::max();
+  // Start at the first mip that fits `streaming_mip_tail_extent` instead of `first`
+  bool tail = false;
 
-    dds::Image dds_image;
-    dds::ReadResult res = dds::readFile(path, &dds_image);
-    if (res != dds::ReadResult::Success)
-      return false;
-    if (dds_image.data.get() == nullptr)
-      return false;
-    if (dds::getBitsPerPixel(dds_image.format) % 8 != 0)
-      return false;
-
-    new_image.width = dds_image.width;
-    new_image.height = dds_image.height;
-    new_image.depth = dds_image.arraySize;
-    new_image.format = (vk::Format)dds::getVulkanFormat(dds_image.format, dds_image.supportsAlpha);
-    new_image.bytes_per_pixel = dds::getBitsPerPixel(dds_image.format) / 8;
-
-    new_image.pixels.reset((std::byte *)dds_image.data.release());
-    new_image.pixels.size(new_image.bytes_per_pixel * new_image.width * new_image.height);
-    int size = 0;
-    for (auto &mip : dds_image.mipmaps) {
-      auto tmp = std::as_bytes(mip);
-      size += mip.size_bytes();
-      new_image.mips.emplace_back(tmp);
+  /** Resolve to [first, last) for a chain of `mip_count` mips of a `width` x `height` image. */
+  std::pair<uint32_t, uint32_t> resolve(uint32_t width, uint32_t height, uint32_t mip_count) const
+  {
+    uint32_t begin = std::min(first, mip_count);
+    if (tail) {
+      begin = 0;
+      while (begin + 1 < mip_count &&
+             std::max(width >> begin, height >> begin) > streaming_mip_tail_extent) {
+        begin++;
+      }
     }
-    new_image.pixels.size(size);
-
-    return new_image.width > 0 && new_image.height > 0 && new_image.bytes_per_pixel > 0;
-  };
+    return {begin, begin + std::min(count, mip_count - begin)};
+  }
+};
 
-  auto load_dds_from_memory = [](const std::byte *data,
-                                  size_t size,
-                                  ImageData &new_image,
-                                  const std::string &context) -> bool {
-    ZoneScopedN("DDS import from memory");
+/** Record that the mips before `first` stay in the source (the caller fills in the path). */
+static void mark_deferred_mips(ImageData &image, uint32_t first)
+{
+  if (first > 0) {
+    image.deferred = DeferredMips{.mip_count = first};
+  }
+}
 
-    dds::Image dds_image;
-    dds::ReadResult res = dds::readImage((uint8_t *)data, size, &dds_image);
-    if (res != dds::ReadResult::Success)
-      return false;
-    if (dds_image.data.get() == nullptr)
-      return false;
-    if (dds::getBitsPerPixel(dds_image.format) % 8 != 0)
-      return false;
+/** Keep only mips [first, last) of `image`, moved into a tightly sized allocation. */
+static void keep_mips(ImageData &image, uint32_t first, uint32_t last)
+{
+  if (first == 0 && last == image.mips.size()) {
+    return;
+  }
 
-    new_image.width = dds_image.width;
-    new_image.height = dds_image.height;
-    new_image.depth = dds_image.arraySize;
-    new_image.format = (vk::Format)dds::getVulkanFormat(dds_image.format, dds_image.supportsAlpha);
-    new_image.bytes_per_pixel = dds::getBitsPerPixel(dds_image.format) / 8;
-
-    new_image.pixels.reset((std::byte *)dds_image.data.release());
-    for (auto &mip : dds_image.mipmaps) {
-      auto tmp = std::as_bytes(mip);
-      size += mip.size_bytes();
-      new_image.mips.emplace_back(std::as_bytes(mip));
-    }
-    new_image.pixels.size(size);
+  ZoneScoped;
 
-    return new_image.width > 0 && new_image.height > 0 && new_image.bytes_per_pixel > 0;
-  };
+  size_t byte_size = 0;
+  for (uint32_t mip = first; mip < last; mip++) {
+    byte_size += image.mips[mip].size();
+  }
 
-  auto load_ktx2_from_file = [](const std::string &path, ImageData &new_image) -> bool {
-    ZoneScopedN("KTX import from file");
+  SizedUniqueArray<std::byte> pixels = std::make_unique_for_overwrite<std::byte[]>(byte_size);
+  pixels.size(byte_size);
+  InplaceVector<std::span<const std::byte>, 16> mips;
+  size_t offset = 0;
+  for (uint32_t mip = first; mip < last; mip++) {
+    std::memcpy(pixels.get() + offset, image.mips[mip].data(), image.mips[mip].size());
+    mips.emplace_back(pixels.get() + offset, image.mips[mip].size());
+    offset += image.mips[mip].size();
+  }
 
-    ktxTexture2 *tex;
-    KTX_error_code result = ktxTexture_CreateFromNamedFile(
-        path.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, (ktxTexture **)&tex);
+  image.pixels = std::move(pixels);
+  image.mips = std::move(mips);
+  mark_deferred_mips(image, first);
+}
 
-    std::unique_ptr<ktxTexture2, void (*)(ktxTexture2 *)> ktx_texture{
-        tex, +[](ktxTexture2 *ptr) { ktxTexture_Destroy((ktxTexture *)ptr); }};
-    if (result != KTX_SUCCESS)
-      return false;
+/** Read a DDS image from memory, the pixels are copied once out of `data`. */
+static bool load_dds_image(
+    std::span<const std::byte> data, ImageData &new_image, MipRange range = {})
+{
+  ZoneScopedN("DDS import");
 
-    if (ktxTexture2_NeedsTranscoding(ktx_texture.get())) {
-      result = ktxTexture2_TranscodeBasis(ktx_texture.get(), KTX_TTF_BC7_RGBA, 0);
-      if (result != KTX_SUCCESS) {
-        return false;
-      }
-    }
+  dds::Image dds_image;
+  dds::ReadResult res = dds::readImage((uint8_t *)data.data(), data.size(), &dds_image);
+  if (res != dds::ReadResult::Success)
+    return false;
+  if (dds_image.data.get() == nullptr)
+    return false;
+  if (dds::getBitsPerPixel(dds_image.format) % 8 != 0)
+    return false;
 
-    new_image.height = ktx_texture->baseHeight;
-    new_image.width = ktx_texture->baseWidth;
-    new_image.depth = ktx_texture->baseDepth;
-    new_image.format = (vk::Format)ktxTexture2_GetVkFormat(ktx_texture.get());
-    new_image.bytes_per_pixel = format_byte_size(new_image.format);
+  new_image.width = dds_image.width;
+  new_image.height = dds_image.height;
+  new_image.depth = dds_image.arraySize;
+  new_image.format = (vk::Format)dds::getVulkanFormat(dds_image.format, dds_image.supportsAlpha);
+  new_image.bytes_per_pixel = dds::getBitsPerPixel(dds_image.format) / 8;
+
+  new_image.pixels.reset((std::byte *)dds_image.data.release());
+  size_t size = 0;
+  for (auto &mip : dds_image.mipmaps) {
+    size += mip.size_bytes();
+    new_image.mips.emplace_back(std::as_bytes(mip));
+  }
+  new_image.pixels.size(size);
 
-    new_image.pixels = std::make_unique_for_overwrite<std::byte[]>(ktx_texture->dataSize);
-    new_image.pixels.size(ktx_texture->dataSize);
-    std::memcpy(new_image.pixels.get(), ktx_texture->pData, ktx_texture->dataSize);
-
-    for (uint32_t mip_index = 0; mip_index < ktx_texture->numLevels; mip_index++) {
-      uint32_t copy_width = new_image.width >> mip_index;
-      uint32_t copy_height = new_image.height >> mip_index;
-      ktx_size_t copy_buffer_offset = 0;
-      result = ktxTexture_GetImageOffset(
-          (ktxTexture *)ktx_texture.get(), mip_index, 0, 0, &copy_buffer_offset);
-      if (result != KTX_SUCCESS) {
-        continue;
-      }
+  // The DDS reader always copies the whole file, so a partial load only trims afterwards
+  const auto [first, last] =
+      range.resolve(new_image.width, new_image.height, new_image.mips.size());
+  keep_mips(new_image, first, last);
 
-      new_image.mips.emplace_back(new_image.pixels.get() + copy_buffer_offset,
-          copy_width * copy_height * new_image.bytes_per_pixel);
-    }
+  return new_image.width > 0 && new_image.height > 0 && new_image.bytes_per_pixel > 0;
+}
 
-    return true;
+/**
+ * Copy levels [first, last) of a KTX2 file without supercompression straight from `data`,
+ * using the level index that follows the fixed-size header.
+ */
+static bool load_ktx2_levels(std::span<const std::byte> data,
+    const ktxTexture2 &texture,
+    uint32_t first,
+    uint32_t last,
+    ImageData &new_image)
+{
+  constexpr size_t level_index_offset = 80;
+  constexpr size_t level_entry_size = 3 * sizeof(uint64_t);
+
+  // KTX2 is little-endian, like every platform we target
+  auto level_entry = [&](uint32_t level, size_t field) {
+    uint64_t value = 0;
+    std::memcpy(&value,
+        data.data() + level_index_offset + level * level_entry_size + field * sizeof(uint64_t),
+        sizeof(value));
+    return value;
   };
 
-  auto load_ktx2_from_memory = [](const std::byte *data,
-                                   size_t size,
-                                   ImageData &new_image,
-                                   const std::string &context) -> bool {
-    ZoneScopedN("KTX import from memory");
-
-    ktxTexture2 *tex;
-    KTX_error_code result = ktxTexture2_CreateFromMemory(
-        (const ktx_uint8_t *)data, size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &tex);
-
-    std::unique_ptr<ktxTexture2, void (*)(ktxTexture2 *)> ktx_texture{
-        tex, +[](ktxTexture2 *ptr) { ktxTexture_Destroy((ktxTexture *)ptr); }};
+  if (data.size() < level_index_offset + texture.numLevels * level_entry_size) {
+    return false;
+  }
 
-    if (result != KTX_SUCCESS)
+  size_t byte_size = 0;
+  for (uint32_t level = first; level < last; level++) {
+    const uint64_t offset = level_entry(level, 0);
+    const uint64_t length = level_entry(level, 1);
+    if (offset > data.size() || length > data.size() - offset) {
       return false;
-
-    if (ktxTexture2_NeedsTranscoding(ktx_texture.get())) {
-      result = ktxTexture2_TranscodeBasis(ktx_texture.get(), KTX_TTF_BC7_RGBA, 0);
-      if (result != KTX_SUCCESS) {
-        return false;
-      }
     }
+    byte_size += length;
+  }
 
-    new_image.height = ktx_texture->baseHeight;
-    new_image.width = ktx_texture->baseWidth;
-    new_image.depth = ktx_texture->baseDepth;
-    new_image.format = (vk::Format)ktxTexture2_GetVkFormat(ktx_texture.get());
-    new_image.bytes_per_pixel = format_byte_size(new_image.format);
-
-    new_image.pixels = std::make_unique_for_overwrite<std::byte[]>(ktx_texture->dataSize);
-    new_image.pixels.size(ktx_texture->dataSize);
-    std::memcpy(new_image.pixels.get(), ktx_texture->pData, ktx_texture->dataSize);
-
-    for (uint32_t mip_index = 0; mip_index < ktx_texture->numLevels; mip_index++) {
-      uint32_t copy_width = new_image.width >> mip_index;
-      uint32_t copy_height = new_image.height >> mip_index;
-      ktx_size_t copy_buffer_offset = 0;
-      result = ktxTexture_GetImageOffset(
-          (ktxTexture *)ktx_texture.get(), mip_index, 0, 0, &copy_buffer_offset);
-      if (result != KTX_SUCCESS) {
-        continue;
-      }
+  new_image.pixels = std::make_unique_for_overwrite<std::byte[]>(byte_size);
+  new_image.pixels.size(byte_size);
+  size_t offset = 0;
+  for (uint32_t level = first; level < last; level++) {
+    const uint64_t length = level_entry(level, 1);
+    std::memcpy(new_image.pixels.get() + offset, data.data() + level_entry(level, 0), length);
+    new_image.mips.emplace_back(new_image.pixels.get() + offset, length);
+    offset += length;
+  }
+  mark_deferred_mips(new_image, first);
+  return true;
+}
 
-      new_image.mips.emplace_back(new_image.pixels.get() + copy_buffer_offset,
-          copy_width * copy_height * new_image.bytes_per_pixel);
-    }
+/**
+ * Read a KTX2 image from memory, transcoding Basis payloads to BC7.
+ *
+ * Regular payloads are inflated/copied by libktx straight into our allocation. Transcoded
+ * ones end up in a malloc'ed libktx buffer, which the image adopts with a `free` deleter.
+ * A partial mip range of an uncompressed payload only reads the requested levels.
+ */
+static bool load_ktx2_image(
+    std::span<const std::byte> data, ImageData &new_image, MipRange range = {})
+{
+  ZoneScopedN("KTX import");
 
-    return true;
-  };
+  ktxTexture2 *tex;
+  KTX_error_code result = ktxTexture2_CreateFromMemory(
+      (const ktx_uint8_t *)data.data(), data.size(), KTX_TEXTURE_CREATE_NO_FLAGS, &tex);
 
-  auto try_load_wuffs_from_file = [](const std::string &path, ImageData &new_image) -> bool {
-    ZoneScopedN("WUFFS import from file");
+  std::unique_ptr<ktxTexture2, void (*)(ktxTexture2 *)> ktx_texture{
+      tex, +[](ktxTexture2 *ptr) { ktxTexture_Destroy((ktxTexture *)ptr); }};
 
-    std::unique_ptr<FILE, int (*)(FILE *)> file(fopen(path.c_str(), "rb"), fclose);
-    if (file.get() == nullptr) {
-      MR_INFO("Failed to open image file {}", path.c_str());
-      return false;
-    }
+  if (result != KTX_SUCCESS)
+    return false;
 
-    wuffs_aux::DecodeImageCallbacks callbacks;
-    wuffs_aux::sync_io::FileInput input(file.get());
-    wuffs_aux::DecodeImageResult img = wuffs_aux::DecodeImage(callbacks, input);
+  const auto [first, last] =
+      range.resolve(ktx_texture->baseWidth, ktx_texture->baseHeight, ktx_texture->numLevels);
+  const bool is_partial = first != 0 || last != ktx_texture->numLevels;
 
-    if (!img.error_message.empty()) {
-      MR_INFO("Failed to parse image: {}", img.error_message);
+  ktxTexture *base_texture = (ktxTexture *)ktx_texture.get();
+  if (ktxTexture2_NeedsTranscoding(ktx_texture.get())) {
+    result = ktxTexture_LoadImageData(base_texture, nullptr, 0);
+    if (result != KTX_SUCCESS) {
       return false;
     }
-    if (!img.pixbuf.pixcfg.is_valid()) {
-      MR_INFO("Failed to parse image for unknown reason");
+    result = ktxTexture2_TranscodeBasis(ktx_texture.get(), KTX_TTF_BC7_RGBA, 0);
+    if (result != KTX_SUCCESS) {
       return false;
     }
 
-    wuffs_base__table_u8 tab = img.pixbuf.plane(0);
-    wuffs_base__pixel_format format = img.pixbuf.pixel_format();
-
-    if (format.bits_per_pixel() % 8 != 0) {
-      MR_INFO("Image format bits_per_pixel % 8 != 0. "
-              "To handle such cases you'd need to change public API from "
-              "byte_size to bit_size");
+    // Adopt the transcoded payload libktx malloc'ed instead of copying it
+    new_image.pixels = SizedUniqueArray<std::byte>((std::byte *)ktx_texture->pData,
+        ArrayDeleter<std::byte>(+[](void *ptr) { std::free(ptr); }));
+    new_image.pixels.size(ktx_texture->dataSize);
+    ktx_texture->pData = nullptr;
+  }
+  else if (is_partial && ktx_texture->supercompressionScheme == KTX_SS_NONE) {
+    if (!load_ktx2_levels(data, *ktx_texture, first, last, new_image)) {
       return false;
     }
-
-    new_image.bytes_per_pixel = format.bits_per_pixel() / 8;
-    new_image.width = tab.width / new_image.bytes_per_pixel;
-    new_image.height = tab.height;
-
-    if (new_image.width <= 0 || new_image.height <= 0 || new_image.bytes_per_pixel <= 0) {
-      MR_INFO("Image format bits_per_pixel % 8 != 0. "
-              "To handle such cases you'd need to change public API from "
-              "byte_size to bit_size");
+  }
+  else {
+    const ktx_size_t data_size = ktxTexture_GetDataSizeUncompressed(base_texture);
+    new_image.pixels = std::make_unique_for_overwrite<std::byte[]>(data_size);
+    new_image.pixels.size(data_size);
+    result = ktxTexture_LoadImageData(
+        base_texture, (ktx_uint8_t *)new_image.pixels.get(), data_size);
+    if (result != KTX_SUCCESS) {
+      new_image.pixels.reset();
       return false;
     }
+  }
 
-    new_image.pixels.reset((std::byte *)img.pixbuf_mem_owner.release());
-    new_image.pixels.size(new_image.width * new_image.height * new_image.bytes_per_pixel);
-    new_image.mips.emplace_back(new_image.pixels.get(), new_image.pixels.size());
+  new_image.height = ktx_texture->baseHeight;
+  new_image.width = ktx_texture->baseWidth;
+  new_image.depth = ktx_texture->baseDepth;
+  new_image.format = (vk::Format)ktxTexture2_GetVkFormat(ktx_texture.get());
+  new_image.bytes_per_pixel = format_byte_size(new_image.format);
+
+  if (!new_image.mips.empty()) {
     return true;
-  };
+  }
 
-  auto try_load_wuffs_from_memory = [](const std::byte *data,
-                                        size_t size,
-                                        ImageData &new_image,
-                                        const std::string &context) -> bool {
-    ZoneScopedN("WUFFS import from memory");
+  for (uint32_t mip_index = 0; mip_index < ktx_texture->numLevels; mip_index++) {
+    ktx_size_t mip_offset = 0;
+    result = ktxTexture_GetImageOffset(base_texture, mip_index, 0, 0, &mip_offset);
+    if (result != KTX_SUCCESS) {
+      continue;
+    }
 
-    wuffs_aux::DecodeImageCallbacks callbacks;
-    wuffs_aux::sync_io::MemoryInput input((const char *)data, size);
-    wuffs_aux::DecodeImageResult img = wuffs_aux::DecodeImage(callbacks, input);
+    // libktx knows the block layout, so this is right for BCn/ASTC as well as plain pixels
+    const ktx_size_t mip_size = ktxTexture_GetImageSize(base_texture, mip_index) *
+                                ktx_texture->numFaces * std::max(ktx_texture->numLayers, 1u) *
+                                std::max(ktx_texture->baseDepth >> mip_index, 1u);
+    new_image.mips.emplace_back(new_image.pixels.get() + mip_offset, mip_size);
+  }
 
-    if (!img.error_message.empty()) {
-      MR_INFO("Failed to parse image: {}", img.error_message);
-      return false;
-    }
-    if (!img.pixbuf.pixcfg.is_valid()) {
-      MR_INFO("Failed to parse image for unknown reason");
-      return false;
-    }
+  // Supercompressed or transcoded payloads had to be expanded whole
+  keep_mips(new_image, first, last);
 
-    wuffs_base__table_u8 tab = img.pixbuf.plane(0);
-    wuffs_base__pixel_format format = img.pixbuf.pixel_format();
+  return true;
+}
 
-    if (format.bits_per_pixel() % 8 != 0) {
-      MR_INFO("Image format bits_per_pixel % 8 != 0. "
-              "To handle such cases you'd need to change public API from "
-              "byte_size to bit_size");
-      return false;
-    }
+/** Map a KTX2/DDS file and read mips `range` of it, recording `path` for deferred mips. */
+static bool load_texture_file_mips(
+    const std::filesystem::path &path, MipRange range, ImageData &new_image)
+{
+  std::optional<MappedFile> file = MappedFile::open(path);
+  if (!file.has_value()) {
+    return false;
+  }
 
-    new_image.bytes_per_pixel = format.bits_per_pixel() / 8;
-    new_image.width = tab.width / new_image.bytes_per_pixel;
-    new_image.height = tab.height;
+  constexpr std::array<uint8_t, 12> ktx2_magic = {
+      0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+  const bool is_ktx2 = file->size() >= ktx2_magic.size() &&
+                       std::memcmp(file->data(), ktx2_magic.data(), ktx2_magic.size()) == 0;
 
-    if (new_image.width <= 0 || new_image.height <= 0 || new_image.bytes_per_pixel <= 0) {
-      return false;
-    }
+  const bool loaded = is_ktx2 ? load_ktx2_image(file->bytes(), new_image, range)
+                              : load_dds_image(file->bytes(), new_image, range);
+  if (loaded && new_image.deferred.has_value()) {
+    new_image.deferred->path = path;
+  }
+  return loaded;
+}
 
-    new_image.pixels.reset((std::byte *)img.pixbuf_mem_owner.release());
-    new_image.pixels.size(new_image.width * new_image.height * new_image.bytes_per_pixel);
-    new_image.mips.emplace_back((std::byte *)tab.ptr, new_image.pixels.size());
-    return true;
-  };
+/**
+ * Decode a glTF image.
+ *
+ * Supports URI, embedded vector, and buffer view sources. Returns an
+ * ImageData with owned memory; logs warnings for unexpected sources.
+ */
+static std::optional<ImageData> get_image_from_gltf(const std::filesystem::path &directory,
+    Options options,
+    const fastgltf::Asset &asset,
+    const fastgltf::Image &image)
+{
+  ZoneScoped;
+
+  ImageData new_image{};
 
   auto try_load_with_fallback = [&](const std::byte *data,
                                     size_t size,
                                     fastgltf::MimeType mimeType,
-                                    const std::string &context_info = "") -> bool {
+                                    const std::string &context_info = "",
+                                    MipRange range = {}) -> bool {
+    const std::span<const std::byte> bytes(data, size);
+
     if (mimeType == fastgltf::MimeType::DDS) {
-      return load_dds_from_memory(data, size, new_image, context_info);
+      return load_dds_image(bytes, new_image, range);
     }
 
     if (mimeType == fastgltf::MimeType::KTX2) {
-      return load_ktx2_from_memory(data, size, new_image, context_info);
+      return load_ktx2_image(bytes, new_image, range);
     }
 
-    if (try_load_wuffs_from_memory(data, size, new_image, context_info)) {
-      return true;
+    {
+      ZoneScopedN("WUFFS import");
+      if (decode_wuffs_image(bytes, options, new_image)) {
+        return true;
+      }
     }
 
     if (mimeType == fastgltf::MimeType::GltfBuffer || mimeType == fastgltf::MimeType::OctetStream) {
-      if (load_dds_from_memory(data, size, new_image, context_info)) {
+      MR_INFO("WUFFS failed for ambiguous mime type, trying DDS then KTX2 {}", context_info);
+
+      if (load_dds_image(bytes, new_image, range)) {
         return true;
       }
-      if (load_ktx2_from_memory(data, size, new_image, context_info)) {
+      if (load_ktx2_image(bytes, new_image, range)) {
         return true;
       }
     }
@@ -1150,31 +1434,31 @@ static std::optional<ImageData> get_image_from_gltf(const std::filesystem::path
 
   auto try_load_file_with_fallback = [&](const std::string &path,
                                          fastgltf::MimeType mimeType) -> bool {
-    if (mimeType == fastgltf::MimeType::DDS || std::filesystem::path(path).extension() == ".dds") {
-      return load_dds_from_file(path, new_image);
-    }
+    ZoneScopedN("Import from file");
 
-    if (mimeType == fastgltf::MimeType::KTX2 ||
-        std::filesystem::path(path).extension() == ".ktx2") {
-      return load_ktx2_from_file(path, new_image);
+    // Every decoder reads straight from the mapping, whichever of them succeeds
+    std::optional<MappedFile> file = MappedFile::open(path);
+    if (!file.has_value()) {
+      return false;
     }
 
-    if (try_load_wuffs_from_file(path, new_image)) {
-      return true;
+    const std::filesystem::path extension = std::filesystem::path(path).extension();
+    if (extension == ".dds") {
+      mimeType = fastgltf::MimeType::DDS;
     }
-
-    if (mimeType == fastgltf::MimeType::GltfBuffer || mimeType == fastgltf::MimeType::OctetStream) {
-      MR_INFO("WUFFS failed for ambiguous mime type, trying DDS then KTX2", path);
-
-      if (load_dds_from_file(path, new_image)) {
-        return true;
-      }
-      if (load_ktx2_from_file(path, new_image)) {
-        return true;
-      }
+    else if (extension == ".ktx2") {
+      mimeType = fastgltf::MimeType::KTX2;
     }
 
-    return false;
+    // Only file sources can be streamed, the mips are read back from the same path later
+    const MipRange range{.tail = is_enabled(options, Options::StreamTextureMips)};
+    if (!try_load_with_fallback(file->data(), file->size(), mimeType, path, range)) {
+      return false;
+    }
+    if (new_image.deferred.has_value()) {
+      new_image.deferred->path = path;
+    }
+    return true;
   };
 
   std::visit(
@@ -1218,38 +1502,16 @@ static std::optional<ImageData> get_image_from_gltf(const std::filesystem::path
             }
           },
           [&](const fastgltf::sources::BufferView &view) {
+            ZoneScopedN("Import from buffer view");
             auto &bufferView = asset.bufferViews[view.bufferViewIndex];
             auto &buffer = asset.buffers[bufferView.bufferIndex];
 
-            std::visit(
-                fastgltf::visitor{[](auto &arg) {
-                                    ASSERT(false,
-                                        "Try to process image from buffer view but not from "
-                                        "RAM "
-                                        "(should be illegal because of LoadExternalBuffers)",
-                                        arg);
-                                  },
-                    [&](const fastgltf::sources::Array &array) {
-                      ZoneScopedN("Import from buffer view array");
-                      const std::byte *data =
-                          (const std::byte *)array.bytes.data() + bufferView.byteOffset;
-                      if (!try_load_with_fallback(
-                              data, bufferView.byteLength, array.mimeType, "buffer view array")) {
-                        PANIC("Failed to load image from buffer view array "
-                              "with all available methods");
-                      }
-                    },
-                    [&](const fastgltf::sources::Vector &vector) {
-                      ZoneScopedN("Import from buffer view vector");
-                      const std::byte *data =
-                          (const std::byte *)vector.bytes.data() + bufferView.byteOffset;
-                      if (!try_load_with_fallback(
-                              data, bufferView.byteLength, vector.mimeType, "buffer view vector")) {
-                        PANIC("Failed to load image from buffer view vector "
-                              "with all available methods");
-                      }
-                    }},
-                buffer.data);
+            const std::span<const std::byte> bytes =
+                get_buffer_bytes(buffer).subspan(bufferView.byteOffset, bufferView.byteLength);
+            if (!try_load_with_fallback(
+                    bytes.data(), bytes.size(), view.mimeType, "buffer view")) {
+              PANIC("Failed to load image from buffer view with all available methods");
+            }
           },
       },
       image.data);
@@ -1587,118 +1849,34 @@ static std::optional<ImageData> decode_image_from_file_path_impl(
 
   ImageData new_image{};
 
-  auto load_dds_from_file_path = [](const std::string &p, ImageData &img) -> bool {
-    ZoneScopedN("DDS import from file");
-    dds::Image dds_image;
-    dds::ReadResult res = dds::readFile(p, &dds_image);
-    if (res != dds::ReadResult::Success)
-      return false;
-    if (dds_image.data.get() == nullptr)
-      return false;
-    if (dds::getBitsPerPixel(dds_image.format) % 8 != 0)
-      return false;
-    img.width = dds_image.width;
-    img.height = dds_image.height;
-    img.depth = dds_image.arraySize;
-    img.format = (vk::Format)dds::getVulkanFormat(dds_image.format, dds_image.supportsAlpha);
-    img.bytes_per_pixel = dds::getBitsPerPixel(dds_image.format) / 8;
-    img.pixels.reset((std::byte *)dds_image.data.release());
-    img.pixels.size(img.bytes_per_pixel * img.width * img.height);
-    int size = 0;
-    for (auto &mip : dds_image.mipmaps) {
-      size += static_cast<int>(mip.size_bytes());
-      img.mips.emplace_back(std::as_bytes(mip));
-    }
-    img.pixels.size(size);
-    return img.width > 0 && img.height > 0 && img.bytes_per_pixel > 0;
-  };
-
-  auto load_ktx2_from_file_path = [](const std::string &p, ImageData &img) -> bool {
-    ZoneScopedN("KTX import from file");
-    ktxTexture2 *tex;
-    KTX_error_code result = ktxTexture_CreateFromNamedFile(
-        p.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, (ktxTexture **)&tex);
-    std::unique_ptr<ktxTexture2, void (*)(ktxTexture2 *)> ktx_texture{
-        tex, +[](ktxTexture2 *ptr) { ktxTexture_Destroy((ktxTexture *)ptr); }};
-    if (result != KTX_SUCCESS)
-      return false;
-    if (ktxTexture2_NeedsTranscoding(ktx_texture.get())) {
-      result = ktxTexture2_TranscodeBasis(ktx_texture.get(), KTX_TTF_BC7_RGBA, 0);
-      if (result != KTX_SUCCESS)
-        return false;
-    }
-    img.height = ktx_texture->baseHeight;
-    img.width = ktx_texture->baseWidth;
-    img.depth = ktx_texture->baseDepth;
-    img.format = (vk::Format)ktxTexture2_GetVkFormat(ktx_texture.get());
-    img.bytes_per_pixel = format_byte_size(img.format);
-    img.pixels = std::make_unique_for_overwrite<std::byte[]>(ktx_texture->dataSize);
-    img.pixels.size(ktx_texture->dataSize);
-    std::memcpy(img.pixels.get(), ktx_texture->pData, ktx_texture->dataSize);
-    for (uint32_t mip_index = 0; mip_index < ktx_texture->numLevels; mip_index++) {
-      uint32_t copy_width = img.width >> mip_index;
-      uint32_t copy_height = img.height >> mip_index;
-      ktx_size_t copy_buffer_offset = 0;
-      result = ktxTexture_GetImageOffset(
-          (ktxTexture *)ktx_texture.get(), mip_index, 0, 0, &copy_buffer_offset);
-      if (result != KTX_SUCCESS)
-        continue;
-      img.mips.emplace_back(
-          img.pixels.get() + copy_buffer_offset, copy_width * copy_height * img.bytes_per_pixel);
-    }
-    return true;
-  };
-
-  auto try_wuffs_file = [](const std::string &p, ImageData &img) -> bool {
-    ZoneScopedN("WUFFS import from file");
-    std::unique_ptr<FILE, int (*)(FILE *)> file(fopen(p.c_str(), "rb"), fclose);
-    if (file.get() == nullptr) {
-      MR_INFO("Failed to open image file {}", p.c_str());
-      return false;
-    }
-    wuffs_aux::DecodeImageCallbacks callbacks;
-    wuffs_aux::sync_io::FileInput input(file.get());
-    wuffs_aux::DecodeImageResult result = wuffs_aux::DecodeImage(callbacks, input);
-    if (!result.error_message.empty()) {
-      MR_INFO("Failed to parse image: {}", result.error_message);
-      return false;
-    }
-    if (!result.pixbuf.pixcfg.is_valid())
-      return false;
-    wuffs_base__table_u8 tab = result.pixbuf.plane(0);
-    wuffs_base__pixel_format format = result.pixbuf.pixel_format();
-    if (format.bits_per_pixel() % 8 != 0)
-      return false;
-    img.bytes_per_pixel = format.bits_per_pixel() / 8;
-    img.width = tab.width / img.bytes_per_pixel;
-    img.height = tab.height;
-    if (img.width <= 0 || img.height <= 0 || img.bytes_per_pixel <= 0)
-      return false;
-    img.pixels.reset((std::byte *)result.pixbuf_mem_owner.release());
-    img.pixels.size(img.width * img.height * img.bytes_per_pixel);
-    img.mips.emplace_back(img.pixels.get(), img.pixels.size());
-    return true;
-  };
+  std::optional<MappedFile> file = MappedFile::open(path);
+  if (!file.has_value()) {
+    return std::nullopt;
+  }
+  const std::span<const std::byte> bytes = file->bytes();
+  const MipRange range{.tail = is_enabled(options, Options::StreamTextureMips)};
 
-  const std::string path_str = path.string();
   if (ext == ".dds") {
-    if (load_dds_from_file_path(path_str, new_image))
+    if (load_dds_image(bytes, new_image, range))
       goto format_fixup;
   }
   if (ext == ".ktx2") {
-    if (load_ktx2_from_file_path(path_str, new_image))
+    if (load_ktx2_image(bytes, new_image, range))
       goto format_fixup;
   }
-  if (try_wuffs_file(path_str, new_image))
+  if (decode_wuffs_image(bytes, options, new_image))
     goto format_fixup;
-  if (load_dds_from_file_path(path_str, new_image))
+  if (load_dds_image(bytes, new_image, range))
     goto format_fixup;
-  if (load_ktx2_from_file_path(path_str, new_image))
+  if (load_ktx2_image(bytes, new_image, range))
     goto format_fixup;
 
   return std::nullopt;
 
 format_fixup:
+  if (new_image.deferred.has_value()) {
+    new_image.deferred->path = path;
+  }
   if (new_image.format == vk::Format()) {
     switch (new_image.bytes_per_pixel) {
     case 1:
@@ -1758,6 +1936,30 @@ std::optional<ImageData> load_image_from_file_path(
   return decode_image_from_file_path_impl(path, options);
 }
 
+std::optional<ImageData> load_deferred_mips(
+    const DeferredMips &deferred, uint32_t first_mip, uint32_t count)
+{
+  ZoneScoped;
+
+  ImageData image{};
+  if (!load_texture_file_mips(deferred.path, MipRange{.first = first_mip, .count = count}, image)) {
+    MR_ERROR("Failed to load deferred mips {}..{} of {}",
+        first_mip,
+        first_mip + count,
+        deferred.path.string());
+    return std::nullopt;
+  }
+  return image;
+}
+
+std::future<std::optional<ImageData>> load_deferred_mips_async(
+    DeferredMips deferred, uint32_t first_mip, uint32_t count)
+{
+  return std::async(std::launch::async, [deferred = std::move(deferred), first_mip, count] {
+    return load_deferred_mips(deferred, first_mip, count);
+  });
+}
+
 void add_gltf_loader_nodes(FlowGraph &graph, const Options &options)
 {
   ZoneScoped;
@@ -1770,7 +1972,7 @@ void add_gltf_loader_nodes(FlowGraph &graph, const Options &options)
         }
 
         ZoneScoped;
-        graph.asset = get_asset_from_path(graph.path);
+        graph.asset = get_asset_from_path(graph.path, graph.asset_buffers, graph.decoded_buffers);
         if (!graph.asset) {
           MR_ERROR("Failed to load asset from path: {}", graph.path.string());
           fc.stop();
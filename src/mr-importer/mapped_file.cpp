@@ -0,0 +1,147 @@
+/**
+ * \file mapped_file.cpp
+ * \brief POSIX/Win32 implementation of \ref MappedFile.
+ */
+
+#include "mapped_file.hpp"
+
+#include "pch.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mr {
+inline namespace importer {
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path &path)
+{
+  ZoneScoped;
+
+  MappedFile file;
+
+#if defined(_WIN32)
+  HANDLE handle = CreateFileW(path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    MR_INFO("Failed to open file {}", path.string());
+    return std::nullopt;
+  }
+
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(handle, &size)) {
+    CloseHandle(handle);
+    MR_INFO("Failed to query size of file {}", path.string());
+    return std::nullopt;
+  }
+  if (size.QuadPart == 0) {
+    CloseHandle(handle);
+    return file;
+  }
+
+  HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (mapping == nullptr) {
+    MR_INFO("Failed to map file {}", path.string());
+    return std::nullopt;
+  }
+
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    MR_INFO("Failed to map file {}", path.string());
+    return std::nullopt;
+  }
+
+  file._mapping = mapping;
+  file._data = static_cast<const std::byte *>(view);
+  file._size = static_cast<size_t>(size.QuadPart);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    MR_INFO("Failed to open file {}", path.string());
+    return std::nullopt;
+  }
+
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    MR_INFO("Failed to query size of file {}", path.string());
+    return std::nullopt;
+  }
+  if (info.st_size == 0) {
+    close(fd);
+    return file;
+  }
+
+  void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file
+  close(fd);
+  if (view == MAP_FAILED) {
+    MR_INFO("Failed to map file {}", path.string());
+    return std::nullopt;
+  }
+
+  // Decoders read front to back, so ask for aggressive read-ahead
+  madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+  madvise(view, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+
+  file._data = static_cast<const std::byte *>(view);
+  file._size = static_cast<size_t>(info.st_size);
+#endif
+
+  return file;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+  : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0))
+#if defined(_WIN32)
+  , _mapping(std::exchange(other._mapping, nullptr))
+#endif
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+  if (this != &other) {
+    reset();
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+#if defined(_WIN32)
+    _mapping = std::exchange(other._mapping, nullptr);
+#endif
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { reset(); }
+
+void MappedFile::reset() noexcept
+{
+  if (_data == nullptr) {
+    return;
+  }
+
+#if defined(_WIN32)
+  UnmapViewOfFile(_data);
+  CloseHandle(_mapping);
+  _mapping = nullptr;
+#else
+  munmap(const_cast<std::byte *>(_data), _size);
+#endif
+  _data = nullptr;
+  _size = 0;
+}
+} // namespace importer
+} // namespace mr
@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+ * \file mapped_file.hpp
+ * \brief Internal read-only memory mapping of input files.
+ */
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace mr {
+inline namespace importer {
+/**
+ * Read-only view of a whole file mapped into memory.
+ *
+ * Decoders read straight from the page cache instead of going through buffered
+ * stdio, so a cached file costs no read syscalls and no intermediate copy.
+ * Move-only; the mapping lives as long as the object.
+ */
+class MappedFile {
+public:
+  /** Map `path`, returns nothing (and logs) if it can't be opened or mapped. */
+  static std::optional<MappedFile> open(const std::filesystem::path &path);
+
+  MappedFile() = default;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  std::span<const std::byte> bytes() const noexcept { return {_data, _size}; }
+  const std::byte *data() const noexcept { return _data; }
+  size_t size() const noexcept { return _size; }
+
+private:
+  void reset() noexcept;
+
+  const std::byte *_data = nullptr;
+  size_t _size = 0;
+#if defined(_WIN32)
+  void *_mapping = nullptr;
+#endif
+};
+} // namespace importer
+} // namespace mr
@@ -7,6 +7,10 @@
 
 #include "pch.hpp"
 
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
 #include "flowgraph.hpp"
 
 namespace mr {
@@ -323,8 +327,45 @@ void generate_lod_set(Mesh &result, std::span<meshopt_Stream> streams, int lodco
   }
 }
 
+/** Streams that tell vertices apart: positions and every attribute array the mesh carries. */
+std::vector<meshopt_Stream> vertex_streams(const Mesh &mesh)
+{
+  using Quantized3 = QuantizedVertexArray::Quantized3;
+  using Quantized2 = QuantizedVertexArray::Quantized2;
+
+  std::vector<meshopt_Stream> streams = {
+      {mesh.positions.data(), sizeof(Position), sizeof(Position)}};
+  if (!mesh.attributes.empty()) {
+    streams.push_back({mesh.attributes.data(), sizeof(VertexAttributes), sizeof(VertexAttributes)});
+  }
+  if (!mesh.quantized.normals.empty()) {
+    streams.push_back({mesh.quantized.normals.data(), sizeof(Quantized3), sizeof(Quantized3)});
+  }
+  if (!mesh.quantized.texcoords.empty()) {
+    streams.push_back({mesh.quantized.texcoords.data(), sizeof(Quantized2), sizeof(Quantized2)});
+  }
+  return streams;
+}
+
+/** `vertices` reordered by `remap`, empty arrays stay empty. */
+template <typename T>
+std::vector<T> remap_vertices(
+    const std::vector<T> &vertices, const IndexArray &remap, size_t vertex_count)
+{
+  std::vector<T> result;
+  if (!vertices.empty()) {
+    result.resize(vertex_count);
+    meshopt_remapVertexBuffer(
+        result.data(), vertices.data(), vertices.size(), sizeof(T), remap.data());
+  }
+  return result;
+}
+
 /**
  * Optimize mesh geometry data layout.
+ *
+ * Quantized meshes come in with float `positions` for the passes that need them; their
+ * quantized arrays are remapped alongside.
  */
 Mesh optimize_data_layout(Mesh mesh)
 {
@@ -340,9 +381,13 @@ Mesh optimize_data_layout(Mesh mesh)
 
   Mesh result;
   result.transforms = std::move(mesh.transforms);
+  result.animation = std::move(mesh.animation);
   result.name = std::move(mesh.name);
   result.aabb = mesh.aabb;
   result.material = mesh.material;
+  result.quantized.position_decode = mesh.quantized.position_decode;
+  result.quantized.normal_decode = mesh.quantized.normal_decode;
+  result.quantized.texcoord_decode = mesh.quantized.texcoord_decode;
 
   auto [count, ratio] = determine_lod_count_and_ratio(mesh.positions, mesh.lods[0].indices);
   result.indices.reserve(2 * mesh.indices.size() * (count + 1));
@@ -371,14 +416,18 @@ Mesh optimize_data_layout(Mesh mesh)
   size_t vertex_count = 0;
   IndexArray remap;
   remap.resize(mesh.indices.size());
-  if (!mesh.attributes.empty()) {
+  const bool animated_positions = !result.animation.position_deltas.empty();
+  if (animated_positions) {
+    // Vertices equal in the first frame may part later, so only drop unused ones and reorder;
+    // the remap is then applied to every frame of deltas
+    ZoneScopedN("meshopt_optimizeVertexFetchRemap");
+    vertex_count = meshopt_optimizeVertexFetchRemap(
+        remap.data(), mesh.indices.data(), mesh.indices.size(), mesh.positions.size());
+  }
+  else if (const std::vector<meshopt_Stream> streams = vertex_streams(mesh);
+           streams.size() > 1) {
     ZoneScopedN("meshopt_generateVertexRemapMulti");
 
-    std::array streams = {
-        meshopt_Stream{ mesh.positions.data(),         sizeof(Position),         sizeof(Position)},
-        meshopt_Stream{mesh.attributes.data(), sizeof(VertexAttributes), sizeof(VertexAttributes)},
-    };
-
     vertex_count = meshopt_generateVertexRemapMulti(remap.data(),
         mesh.indices.data(),
         mesh.indices.size(),
@@ -419,6 +468,23 @@ Mesh optimize_data_layout(Mesh mesh)
           sizeof(VertexAttributes),
           remap.data());
     }
+    result.quantized.positions = remap_vertices(mesh.quantized.positions, remap, vertex_count);
+    result.quantized.normals = remap_vertices(mesh.quantized.normals, remap, vertex_count);
+    result.quantized.texcoords = remap_vertices(mesh.quantized.texcoords, remap, vertex_count);
+    if (animated_positions) {
+      using QuantizedDelta = MeshAnimation::QuantizedDelta;
+      const std::vector<QuantizedDelta> &deltas = result.animation.position_deltas;
+      const size_t frames = deltas.size() / mesh.positions.size();
+      std::vector<QuantizedDelta> remapped(frames * vertex_count);
+      tbb::parallel_for(size_t(0), frames, [&](size_t frame) {
+        meshopt_remapVertexBuffer(remapped.data() + frame * vertex_count,
+            deltas.data() + frame * mesh.positions.size(),
+            mesh.positions.size(),
+            sizeof(QuantizedDelta),
+            remap.data());
+      });
+      result.animation.position_deltas = std::move(remapped);
+    }
   }
 
   {
@@ -435,14 +501,16 @@ Mesh optimize_data_layout(Mesh mesh)
   result.lods[0].indices = IndexSpan(result.indices.data(), ntri_idx);
   result.lods[0].shadow_indices = IndexSpan(result.indices.data() + ntri_idx, ntri_idx);
 
-  if (!mesh.attributes.empty()) {
+  if (animated_positions) {
+    // Positions shared in the first frame are not shared in every frame
+    std::copy(result.lods[0].indices.begin(),
+        result.lods[0].indices.end(),
+        result.lods[0].shadow_indices.begin());
+  }
+  else if (const std::vector<meshopt_Stream> streams = vertex_streams(result);
+           streams.size() > 1) {
     ZoneScopedN("meshopt_generateShadowIndexBufferMulti");
 
-    std::array streams = {
-        meshopt_Stream{ result.positions.data(),         sizeof(Position),         sizeof(Position)},
-        meshopt_Stream{result.attributes.data(), sizeof(VertexAttributes), sizeof(VertexAttributes)},
-    };
-
     meshopt_generateShadowIndexBufferMulti(result.lods[0].shadow_indices.data(),
         result.lods[0].indices.data(),
         result.lods[0].indices.size(),
@@ -468,7 +536,8 @@ Mesh generate_mesh_attributes(Mesh mesh)
 {
   ZoneScoped;
 
-  if (mesh.indices.empty() || mesh.positions.empty() || !mesh.attributes.empty()) {
+  if (mesh.indices.empty() || mesh.positions.empty() || !mesh.attributes.empty() ||
+      !mesh.quantized.normals.empty()) {
     return mesh;
   }
   if (mesh.lods.empty() || mesh.lods[0].indices.size() != mesh.indices.size()) {
@@ -516,8 +585,137 @@ Mesh generate_mesh_attributes(Mesh mesh)
   return mesh;
 }
 
+/** Fast 64-bit hash of raw bytes; collisions are resolved by comparing the bytes. */
+static uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) noexcept
+{
+  constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+
+  const auto *bytes = static_cast<const std::byte *>(data);
+  uint64_t hash = seed ^ (size * multiplier);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    hash = std::rotl((hash ^ word) * multiplier, 31);
+  }
+  uint64_t tail = 0;
+  if (i < size) {
+    std::memcpy(&tail, bytes + i, size - i);
+  }
+  hash = (hash ^ tail) * multiplier;
+  return hash ^ (hash >> 29);
+}
+
+template <typename T>
+static bool same_bytes(const std::vector<T> &a, const std::vector<T> &b) noexcept
+{
+  return a.size() == b.size() &&
+         (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+/** Hash of everything that makes two meshes render the same, except their transforms. */
+static uint64_t hash_geometry(const Mesh &mesh) noexcept
+{
+  using Quantized3 = QuantizedVertexArray::Quantized3;
+
+  uint64_t hash = mesh.material;
+  hash = hash_bytes(mesh.positions.data(), mesh.positions.size() * sizeof(Position), hash);
+  hash = hash_bytes(mesh.quantized.positions.data(),
+      mesh.quantized.positions.size() * sizeof(Quantized3),
+      hash);
+  hash = hash_bytes(mesh.indices.data(), mesh.indices.size() * sizeof(Index), hash);
+  hash = hash_bytes(
+      mesh.attributes.data(), mesh.attributes.size() * sizeof(VertexAttributes), hash);
+  return hash;
+}
+
+static bool same_decode(
+    const QuantizedVertexArray::Decode &a, const QuantizedVertexArray::Decode &b) noexcept
+{
+  return a.scale == b.scale && a.offset == b.offset;
+}
+
+static bool same_quantized(const QuantizedVertexArray &a, const QuantizedVertexArray &b) noexcept
+{
+  return same_bytes(a.positions, b.positions) && same_bytes(a.normals, b.normals) &&
+         same_bytes(a.texcoords, b.texcoords) &&
+         same_decode(a.position_decode, b.position_decode) &&
+         same_decode(a.normal_decode, b.normal_decode) &&
+         same_decode(a.texcoord_decode, b.texcoord_decode);
+}
+
+static bool same_geometry(const Mesh &a, const Mesh &b) noexcept
+{
+  return a.material == b.material && same_bytes(a.positions, b.positions) &&
+         same_quantized(a.quantized, b.quantized) && same_bytes(a.indices, b.indices) &&
+         same_bytes(a.attributes, b.attributes) &&
+         a.attributes.weights() == b.attributes.weights();
+}
+
 } // namespace
 
+/**
+ * Merge meshes with identical geometry, attributes and material into one mesh whose
+ * transforms are the concatenation of theirs.
+ *
+ * Meshes are hashed in parallel and candidates are confirmed byte for byte, so only true
+ * duplicates merge. The first mesh of each group is kept, in input order.
+ */
+std::vector<Mesh> deduplicate_meshes(std::vector<Mesh> meshes)
+{
+  ZoneScoped;
+
+  std::vector<uint64_t> hashes(meshes.size());
+  tbb::parallel_for(
+      size_t(0), meshes.size(), [&](size_t i) { hashes[i] = hash_geometry(meshes[i]); });
+
+  // Index of the mesh each mesh merges into (itself for unique meshes)
+  std::vector<size_t> representative(meshes.size());
+  std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+  for (size_t i = 0; i < meshes.size(); i++) {
+    representative[i] = i;
+    // Animated meshes carry per-frame data tied to their own transforms, keep them apart
+    if (!meshes[i].animation.empty()) {
+      continue;
+    }
+    std::vector<size_t> &bucket = buckets[hashes[i]];
+    for (size_t candidate : bucket) {
+      if (same_geometry(meshes[candidate], meshes[i])) {
+        representative[i] = candidate;
+        break;
+      }
+    }
+    if (representative[i] == i) {
+      bucket.push_back(i);
+    }
+  }
+
+  std::vector<TransformArray::Table> merged_transforms(meshes.size());
+  for (size_t i = 0; i < meshes.size(); i++) {
+    const std::span<const AffineTransform> transforms = meshes[i].transforms.affine();
+    TransformArray::Table &target = merged_transforms[representative[i]];
+    target.insert(target.end(), transforms.begin(), transforms.end());
+  }
+
+  std::vector<Mesh> result;
+  result.reserve(meshes.size());
+  for (size_t i = 0; i < meshes.size(); i++) {
+    if (representative[i] != i) {
+      continue;
+    }
+    // Unique meshes keep their (possibly shared) table untouched
+    if (merged_transforms[i].size() != meshes[i].transforms.size()) {
+      meshes[i].transforms = TransformArray(std::move(merged_transforms[i]));
+    }
+    result.emplace_back(std::move(meshes[i]));
+  }
+
+  if (result.size() != meshes.size()) {
+    MR_INFO("Merged {} meshes into {} unique meshes", meshes.size(), result.size());
+  }
+  return result;
+}
+
 /*
  * LOAD -> [SPLIT] --> [OPT₁ -> LOD₁ -> MESHLETS₁] --> JOIN -> NEXT
  *                  \-> [OPT₂ -> LOD₂ -> MESHLETS₂]---/
@@ -528,10 +726,14 @@ void add_optimizer_nodes(FlowGraph &graph, const Options &options)
 {
   graph.split_meshes =
       std::make_unique<tbb::flow::function_node<void *, std::vector<size_t>>>(
-          graph.graph, 1, [&graph](void *token) -> std::vector<size_t> {
+          graph.graph, 1, [&graph, &options](void *token) -> std::vector<size_t> {
             if (token == nullptr || !graph.model)
               return {};
 
+            if (options & Options::DeduplicateMeshes) {
+              graph.model->meshes = deduplicate_meshes(std::move(graph.model->meshes));
+            }
+
             std::vector<size_t> indices(graph.model->meshes.size());
             std::iota(indices.begin(), indices.end(), 0);
             return indices;
@@ -547,6 +749,12 @@ void add_optimizer_nodes(FlowGraph &graph, const Options &options)
 
         Mesh &mesh = graph.model->meshes[mesh_idx];
 
+        // Quantized meshes get float positions for the passes below and drop them afterwards
+        const bool quantized = !mesh.quantized.empty();
+        if (quantized) {
+          mesh.positions = mesh.quantized.dequantize_positions();
+        }
+
         if (options & Options::OptimizeMeshes) {
           mesh = optimize_data_layout(std::move(mesh));
         }
@@ -577,6 +785,10 @@ void add_optimizer_nodes(FlowGraph &graph, const Options &options)
         }
         // clang-format on
 
+        if (quantized) {
+          mesh.positions = PositionArray();
+        }
+
         return mesh_idx;
       });
 
@@ -30,6 +30,10 @@
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
 #include <tbb/parallel_invoke.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_group.h>
 
 #include <glm/detail/qualifier.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
@@ -0,0 +1,288 @@
+/**
+ * \file pixels.cpp
+ * \brief Vectorized pixel layout conversion kernels.
+ */
+
+#include "pixels.hpp"
+
+#include "pch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MR_IMPORTER_PIXELS_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define MR_IMPORTER_PIXELS_NEON 1
+#endif
+
+namespace mr {
+inline namespace importer {
+namespace {
+/**
+ * Byte shuffle that widens as many whole pixels as fit into one 16-byte register.
+ * Lanes with 0x80 in `shuffle` come out as zero (pshufb and tbl both do that),
+ * `fill` is OR-ed on top to set the alpha channel.
+ */
+struct ShuffleTable {
+  alignas(16) std::array<uint8_t, 16> shuffle{};
+  alignas(16) std::array<uint8_t, 16> fill{};
+  uint32_t group_pixels = 0;
+};
+
+static ShuffleTable make_shuffle_table(ChannelExpansion expansion)
+{
+  ShuffleTable table;
+  const uint32_t src_size = expansion.src_pixel_size();
+  const uint32_t dst_size = expansion.dst_pixel_size();
+
+  table.group_pixels = 16 / dst_size;
+  for (uint32_t byte = 0; byte < 16; byte++) {
+    const uint32_t pixel = byte / dst_size;
+    const uint32_t offset = byte % dst_size;
+    const uint32_t component = offset / expansion.component_size;
+
+    table.shuffle[byte] = 0x80;
+    if (pixel >= table.group_pixels) {
+      continue;
+    }
+    if (offset < src_size) {
+      table.shuffle[byte] = static_cast<uint8_t>(pixel * src_size + offset);
+    }
+    else if (component == 3) {
+      table.fill[byte] = 0xFF;
+    }
+  }
+
+  return table;
+}
+
+static void expand_pixel(const std::byte *src, std::byte *dst, ChannelExpansion expansion)
+{
+  // Copy through a temporary so the same routine works when src and dst overlap
+  std::byte pixel[16];
+  std::memcpy(pixel, src, expansion.src_pixel_size());
+  for (uint32_t c = expansion.src_components; c < expansion.dst_components; c++) {
+    std::memset(pixel + c * expansion.component_size,
+        c == 3 ? 0xFF : 0x00,
+        expansion.component_size);
+  }
+  std::memcpy(dst, pixel, expansion.dst_pixel_size());
+}
+
+static void expand_scalar(const std::byte *src,
+    std::byte *dst,
+    size_t begin,
+    size_t end,
+    ChannelExpansion expansion)
+{
+  const size_t src_size = expansion.src_pixel_size();
+  const size_t dst_size = expansion.dst_pixel_size();
+  for (size_t i = begin; i < end; i++) {
+    expand_pixel(src + i * src_size, dst + i * dst_size, expansion);
+  }
+}
+
+/**
+ * Number of whole pixel groups, starting at pixel 0, whose 16-byte loads and stores stay
+ * within `pixel_count` source and destination pixels.
+ */
+static size_t simd_group_count(size_t pixel_count, ChannelExpansion expansion)
+{
+  const size_t src_size = expansion.src_pixel_size();
+  const size_t dst_size = expansion.dst_pixel_size();
+  const size_t group = 16 / dst_size;
+  if (pixel_count * src_size < 16) {
+    return 0;
+  }
+  const size_t last_start =
+      std::min((pixel_count * src_size - 16) / src_size, (pixel_count * dst_size - 16) / dst_size);
+  return std::min(last_start / group + 1, pixel_count / group);
+}
+
+#if MR_IMPORTER_PIXELS_X86
+enum struct SimdLevel { Scalar, SSSE3, AVX2 };
+
+static SimdLevel simd_level()
+{
+#if defined(__GNUC__) || defined(__clang__)
+  static const SimdLevel level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+      return SimdLevel::SSSE3;
+    }
+    return SimdLevel::Scalar;
+  }();
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+__attribute__((target("ssse3"))) static void expand_groups_ssse3(const std::byte *src,
+    std::byte *dst,
+    size_t groups,
+    bool backward,
+    ChannelExpansion expansion)
+{
+  const ShuffleTable table = make_shuffle_table(expansion);
+  const __m128i shuffle = _mm_load_si128((const __m128i *)table.shuffle.data());
+  const __m128i fill = _mm_load_si128((const __m128i *)table.fill.data());
+
+  const size_t src_step = table.group_pixels * expansion.src_pixel_size();
+  const size_t dst_step = table.group_pixels * expansion.dst_pixel_size();
+
+  for (size_t k = 0; k < groups; k++) {
+    const size_t g = backward ? groups - 1 - k : k;
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + g * src_step));
+    v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), fill);
+    _mm_storeu_si128((__m128i *)(dst + g * dst_step), v);
+  }
+}
+
+__attribute__((target("avx2"))) static void expand_groups_avx2(const std::byte *src,
+    std::byte *dst,
+    size_t groups,
+    bool backward,
+    ChannelExpansion expansion)
+{
+  const ShuffleTable table = make_shuffle_table(expansion);
+  const __m256i shuffle =
+      _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)table.shuffle.data()));
+  const __m256i fill =
+      _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)table.fill.data()));
+
+  const size_t src_step = table.group_pixels * expansion.src_pixel_size();
+  const size_t dst_step = table.group_pixels * expansion.dst_pixel_size();
+
+  // pshufb works per 128-bit lane, so each lane widens its own group of pixels
+  size_t k = 0;
+  for (; k + 2 <= groups; k += 2) {
+    const size_t g = backward ? groups - 2 - k : k;
+    __m256i v = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(src + g * src_step))),
+        _mm_loadu_si128((const __m128i *)(src + (g + 1) * src_step)),
+        1);
+    v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), fill);
+    // Lower lane first: when a group is shorter than 16 bytes the upper lane store
+    // overwrites the lower lane's zero padding
+    _mm_storeu_si128((__m128i *)(dst + g * dst_step), _mm256_castsi256_si128(v));
+    _mm_storeu_si128((__m128i *)(dst + (g + 1) * dst_step), _mm256_extracti128_si256(v, 1));
+  }
+
+  if (k < groups) {
+    const size_t g = backward ? 0 : groups - 1;
+    expand_groups_ssse3(src + g * src_step, dst + g * dst_step, 1, false, expansion);
+  }
+}
+#endif
+
+/**
+ * Widen `groups` register-sized pixel groups with the best available kernel.
+ * The caller guarantees every 16-byte access stays in bounds.
+ * Returns false when there is no vector kernel for this target.
+ */
+static bool expand_groups(const std::byte *src,
+    std::byte *dst,
+    size_t groups,
+    bool backward,
+    ChannelExpansion expansion)
+{
+#if MR_IMPORTER_PIXELS_X86
+  switch (simd_level()) {
+  case SimdLevel::AVX2:
+    expand_groups_avx2(src, dst, groups, backward, expansion);
+    return true;
+  case SimdLevel::SSSE3:
+    expand_groups_ssse3(src, dst, groups, backward, expansion);
+    return true;
+  case SimdLevel::Scalar:
+    return false;
+  }
+  return false;
+#elif MR_IMPORTER_PIXELS_NEON
+  const ShuffleTable table = make_shuffle_table(expansion);
+  const uint8x16_t shuffle = vld1q_u8(table.shuffle.data());
+  const uint8x16_t fill = vld1q_u8(table.fill.data());
+
+  const size_t src_step = table.group_pixels * expansion.src_pixel_size();
+  const size_t dst_step = table.group_pixels * expansion.dst_pixel_size();
+
+  for (size_t k = 0; k < groups; k++) {
+    const size_t g = backward ? groups - 1 - k : k;
+    uint8x16_t v = vld1q_u8((const uint8_t *)(src + g * src_step));
+    v = vorrq_u8(vqtbl1q_u8(v, shuffle), fill);
+    vst1q_u8((uint8_t *)(dst + g * dst_step), v);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+void expand_channels(
+    const std::byte *src, std::byte *dst, size_t pixel_count, ChannelExpansion expansion)
+{
+  ZoneScoped;
+
+  ASSERT(expansion.dst_components >= expansion.src_components);
+  ASSERT(expansion.dst_pixel_size() <= 16, "Unsupported pixel size", expansion.dst_pixel_size());
+
+  // 64k pixels per task keeps the scheduling overhead negligible even for small mips
+  constexpr size_t grain = 1 << 16;
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, pixel_count, grain),
+      [&](const tbb::blocked_range<size_t> &range) {
+        const size_t count = range.size();
+        const std::byte *chunk_src = src + range.begin() * expansion.src_pixel_size();
+        std::byte *chunk_dst = dst + range.begin() * expansion.dst_pixel_size();
+
+        // Groups never write past the chunk, so neighbouring tasks don't race on padding
+        const size_t groups = simd_group_count(count, expansion);
+        size_t done = 0;
+        if (groups > 0 && expand_groups(chunk_src, chunk_dst, groups, false, expansion)) {
+          done = groups * (16 / expansion.dst_pixel_size());
+        }
+        expand_scalar(chunk_src, chunk_dst, done, count, expansion);
+      });
+}
+
+void expand_channels_in_place(std::byte *pixels, size_t pixel_count, ChannelExpansion expansion)
+{
+  ZoneScoped;
+
+  ASSERT(expansion.dst_components >= expansion.src_components);
+  ASSERT(expansion.dst_pixel_size() <= 16, "Unsupported pixel size", expansion.dst_pixel_size());
+
+  const size_t src_size = expansion.src_pixel_size();
+  const size_t dst_size = expansion.dst_pixel_size();
+  const size_t group = 16 / dst_size;
+
+  // Groups may only run back to front when one fills the whole register, otherwise
+  // its zero padding would land on the already widened pixels after it. A group reads
+  // [g * src, g * src + 16) and writes [g * dst, g * dst + 16): the bytes it needs lie
+  // below everything the later groups wrote, and the reads stay inside the wide buffer.
+  size_t groups = 0;
+  if (16 % dst_size == 0 && pixel_count * src_size >= 16) {
+    groups = pixel_count / group;
+  }
+
+  for (size_t i = pixel_count; i > groups * group; i--) {
+    expand_pixel(pixels + (i - 1) * src_size, pixels + (i - 1) * dst_size, expansion);
+  }
+
+  if (groups > 0 && !expand_groups(pixels, pixels, groups, true, expansion)) {
+    for (size_t i = groups * group; i > 0; i--) {
+      expand_pixel(pixels + (i - 1) * src_size, pixels + (i - 1) * dst_size, expansion);
+    }
+  }
+}
+} // namespace importer
+} // namespace mr
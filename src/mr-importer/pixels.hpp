@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * \file pixels.hpp
+ * \brief Internal pixel layout conversion kernels shared by the image decoders.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mr {
+inline namespace importer {
+/** Interleaved pixel layout change: N components of `component_size` bytes -> M components. */
+struct ChannelExpansion {
+  uint32_t src_components;
+  uint32_t dst_components;
+  uint32_t component_size = 1;
+
+  constexpr uint32_t src_pixel_size() const noexcept { return src_components * component_size; }
+  constexpr uint32_t dst_pixel_size() const noexcept { return dst_components * component_size; }
+};
+
+/**
+ * Widen interleaved pixels from `src` into `dst` (buffers must not overlap).
+ *
+ * The first min(N, M) components are copied, new components are zero-filled except
+ * the 4th one (alpha), which becomes fully opaque. Vectorized with SSSE3/AVX2/NEON
+ * when available and split across the TBB pool.
+ */
+void expand_channels(
+    const std::byte *src, std::byte *dst, size_t pixel_count, ChannelExpansion expansion);
+
+/**
+ * Same as \ref expand_channels, but in place: `pixels` holds `pixel_count` narrow pixels
+ * at its front and must have room for `pixel_count` wide ones.
+ *
+ * Works back to front, so it is sequential; use it when a decoder could write straight
+ * into the final allocation and a second full-size buffer would be the bigger cost.
+ */
+void expand_channels_in_place(std::byte *pixels, size_t pixel_count, ChannelExpansion expansion);
+} // namespace importer
+} // namespace mr
@@ -6,10 +6,13 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/split_free.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/unique_ptr.hpp>
 #include <boost/serialization/vector.hpp>
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <memory>
 
@@ -49,6 +52,43 @@ struct IndexSpanSerializable {
     return IndexSpan(parent_array.data() + offset, count);
   }
 };
+
+/** Leads every archive file, ahead of the boost archive header. */
+constexpr std::array<char, 4> archive_magic = {'M', 'R', 'M', 'D'};
+/**
+ * Bump whenever the serialized layout of a type changes, so archives written by another
+ * build are rejected instead of read as garbage. Version 2 added deferred mips, quantized
+ * vertices, shared transform tables and mesh animation; untagged archives are version 1.
+ */
+constexpr std::uint32_t archive_format_version = 2;
+
+static void write_archive_header(std::ostream &os)
+{
+  os.write(archive_magic.data(), archive_magic.size());
+  os.write(reinterpret_cast<const char *>(&archive_format_version),
+      sizeof(archive_format_version));
+}
+
+/** Consume the header, returns false (and logs) for foreign or outdated archives. */
+static bool read_archive_header(std::istream &is, const std::string &filepath)
+{
+  std::array<char, 4> magic {};
+  std::uint32_t version = 0;
+  is.read(magic.data(), magic.size());
+  is.read(reinterpret_cast<char *>(&version), sizeof(version));
+  if (!is || magic != archive_magic) {
+    MR_ERROR("{} is not a versioned archive, re-import its source asset", filepath);
+    return false;
+  }
+  if (version != archive_format_version) {
+    MR_ERROR("{} has archive format version {}, expected {}, re-import its source asset",
+        filepath,
+        version,
+        archive_format_version);
+    return false;
+  }
+  return true;
+}
 } // namespace
 } // namespace importer
 } // namespace mr
@@ -209,6 +249,47 @@ void serialize(Archive &ar,
   ar & array.cones;
 }
 
+// AffineTransform
+template <class Archive>
+void serialize(
+    Archive &ar, mr::importer::AffineTransform &transform, const unsigned int version)
+{
+  ar & transform.rows;
+}
+
+// QuantizedVertexArray::Decode
+template <class Archive>
+void serialize(Archive &ar,
+    mr::importer::QuantizedVertexArray::Decode &decode,
+    const unsigned int version)
+{
+  ar & decode.scale & decode.offset;
+}
+
+// QuantizedVertexArray
+template <class Archive>
+void serialize(
+    Archive &ar, mr::importer::QuantizedVertexArray &array, const unsigned int version)
+{
+  ar & array.positions;
+  ar & array.normals;
+  ar & array.texcoords;
+  ar & array.position_decode;
+  ar & array.normal_decode;
+  ar & array.texcoord_decode;
+}
+
+// MeshAnimation
+template <class Archive>
+void serialize(
+    Archive &ar, mr::importer::MeshAnimation &animation, const unsigned int version)
+{
+  ar & animation.times;
+  ar & animation.position_deltas;
+  ar & animation.delta_scale;
+  ar & animation.transforms;
+}
+
 // Mesh - with custom span handling
 template <class Archive>
 void save(
@@ -218,6 +299,7 @@ void save(
   ar & mesh.positions;
   ar & mesh.indices;
   ar & mesh.attributes;
+  ar & mesh.quantized;
 
   // Serialize LODs with span handling
   std::size_t lod_count = mesh.lods.size();
@@ -235,7 +317,11 @@ void save(
     ar & lod.meshlet_bounds;
   }
 
-  ar & mesh.transforms;
+  // Tables shared between meshes are tracked by boost and written once
+  auto transforms =
+      std::const_pointer_cast<mr::importer::TransformArray::Table>(mesh.transforms.table());
+  ar & transforms;
+  ar & mesh.animation;
   ar & mesh.name;
   ar & mesh.material;
   ar & mesh.aabb;
@@ -248,6 +334,7 @@ void load(Archive &ar, mr::importer::Mesh &mesh, const unsigned int version)
   ar & mesh.positions;
   ar & mesh.indices;
   ar & mesh.attributes;
+  ar & mesh.quantized;
 
   // Load LODs
   std::size_t lod_count;
@@ -272,7 +359,10 @@ void load(Archive &ar, mr::importer::Mesh &mesh, const unsigned int version)
     mesh.lods[i].shadow_indices = shadow_data[i].to_span(mesh.indices);
   }
 
-  ar & mesh.transforms;
+  std::shared_ptr<mr::importer::TransformArray::Table> transforms;
+  ar & transforms;
+  mesh.transforms = mr::importer::TransformArray(std::move(transforms));
+  ar & mesh.animation;
   ar & mesh.name;
   ar & mesh.material;
   ar & mesh.aabb;
@@ -362,6 +452,15 @@ void save(Archive &ar,
   // Serialize vk::Format
   uint32_t format_val = static_cast<uint32_t>(image.format);
   ar & format_val;
+
+  // Deferred mips stay in their source file, only the reference is cached
+  bool has_deferred = image.deferred.has_value();
+  ar & has_deferred;
+  if (has_deferred) {
+    std::string path = image.deferred->path.string();
+    ar & path;
+    ar & image.deferred->mip_count;
+  }
 }
 
 template <class Archive>
@@ -395,6 +494,17 @@ void load(
   uint32_t format_val;
   ar & format_val;
   image.format = static_cast<vk::Format>(format_val);
+
+  bool has_deferred;
+  ar & has_deferred;
+  image.deferred.reset();
+  if (has_deferred) {
+    std::string path;
+    ar & path;
+    image.deferred.emplace();
+    image.deferred->path = path;
+    ar & image.deferred->mip_count;
+  }
 }
 
 template <class Archive>
@@ -568,6 +678,7 @@ bool serialize(const Model &model, const std::string &filepath)
     return false;
   }
 
+  write_archive_header(ofs);
   try {
     boost::archive::binary_oarchive oa(ofs);
     oa << model;
@@ -591,6 +702,9 @@ std::optional<Model> deserialize(const std::string &filepath)
     MR_ERROR("Failed to open file for reading: {}", filepath);
     return std::nullopt;
   }
+  if (!read_archive_header(ifs, filepath)) {
+    return std::nullopt;
+  }
 
   Model model;
   try {
@@ -617,6 +731,7 @@ bool serialize(const Mesh &mesh, const std::string &filepath)
     return false;
   }
 
+  write_archive_header(ofs);
   try {
     boost::archive::binary_oarchive oa(ofs);
     oa << mesh;
@@ -640,6 +755,9 @@ std::optional<Mesh> deserialize_mesh(const std::string &filepath)
     MR_ERROR("Failed to open file for reading: {}", filepath);
     return std::nullopt;
   }
+  if (!read_archive_header(ifs, filepath)) {
+    return std::nullopt;
+  }
 
   Mesh mesh;
   try {
@@ -666,6 +784,7 @@ bool serialize(const MaterialData &material, const std::string &filepath)
     return false;
   }
 
+  write_archive_header(ofs);
   try {
     boost::archive::binary_oarchive oa(ofs);
     oa << material;
@@ -689,6 +808,9 @@ std::optional<MaterialData> deserialize_material(const std::string &filepath)
     MR_ERROR("Failed to open file for reading: {}", filepath);
     return std::nullopt;
   }
+  if (!read_archive_header(ifs, filepath)) {
+    return std::nullopt;
+  }
 
   MaterialData material;
   try {
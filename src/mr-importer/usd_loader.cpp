@@ -5,16 +5,17 @@
  * Pipeline overview, conventions (row vs column matrices, up-axis, payloads), and
  * troubleshooting: see repository file \c docs/USD_LOADER.md.
  *
- * Summary: open stage with an asset resolver context; load all payloads; traverse with
- * instance proxies; apply stage up-axis as \c world * upCorr (USD row vectors); convert
- * \c GfMatrix4d to \c Transform via transpose for column-vector APIs; extract
- * \c UsdGeomMesh (with guide-purpose filtering), \c UsdPreviewSurface materials,
- * \c UsdLux lights, and \c UsdGeomCamera. Registered from \c add_usd_loader_nodes()
- * on the import flow graph.
+ * Summary: open stage with an asset resolver context (optionally population-masked); load all
+ * or the requested payloads; traverse once, placing instance prototypes per instance; apply
+ * stage up-axis as \c world * upCorr (USD row vectors); convert \c GfMatrix4d to \c Transform
+ * via transpose for column-vector APIs; extract \c UsdGeomMesh (with guide-purpose
+ * filtering), \c UsdPreviewSurface materials, \c UsdLux lights, and \c UsdGeomCamera.
+ * Registered from \c add_usd_loader_nodes() on the import flow graph.
  */
 
 #include "mr-importer/importer.hpp"
 
+#include "bounds.hpp"
 #include "flowgraph.hpp"
 #include "pch.hpp"
 
@@ -34,14 +35,17 @@
 #include <pxr/usd/usd/primFlags.h>
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/stagePopulationMask.h>
 #include <pxr/usd/usdGeom/camera.h>
 #include <pxr/usd/usdGeom/imageable.h>
 #include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
 #include <pxr/usd/usdGeom/metrics.h>
 #include <pxr/usd/usdGeom/primvar.h>
 #include <pxr/usd/usdGeom/primvarsAPI.h>
 #include <pxr/usd/usdGeom/tokens.h>
 #include <pxr/usd/usdGeom/xformable.h>
+#include <pxr/usd/usdGeom/xformCache.h>
 #include <pxr/usd/usdLux/cylinderLight.h>
 #include <pxr/usd/usdLux/diskLight.h>
 #include <pxr/usd/usdLux/distantLight.h>
@@ -56,12 +60,17 @@
 #include <pxr/usd/usdShade/tokens.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <functional>
 #include <mutex>
+#include <numeric>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 #include <string_view>
 
@@ -162,6 +171,18 @@ static Transform matr4f_from_gf_matrix(GfMatrix4d const &g)
       t[3][3]);
 }
 
+/** Same convention as matr4f_from_gf_matrix, keeping only the affine rows. */
+static AffineTransform affine_from_gf_matrix(GfMatrix4d const &g)
+{
+  AffineTransform t;
+  for (int r = 0; r < 3; ++r) {
+    for (int c = 0; c < 4; ++c) {
+      t.rows[r][c] = static_cast<float>(g[c][r]);
+    }
+  }
+  return t;
+}
+
 static GfMatrix4d stage_up_axis_correction(UsdStageRefPtr const &stage)
 {
   TfToken up = UsdGeomGetStageUpAxis(stage);
@@ -173,29 +194,6 @@ static GfMatrix4d stage_up_axis_correction(UsdStageRefPtr const &stage)
   return GfMatrix4d(1.0);
 }
 
-static void triangulate_faces_from_counts(int const *face_vertex_counts,
-    size_t nfaces,
-    int const *face_vertex_indices,
-    std::vector<Index> &out)
-{
-  out.clear();
-  int idx = 0;
-  for (size_t fi = 0; fi < nfaces; ++fi) {
-    int const n = face_vertex_counts[fi];
-    if (n < 3) {
-      idx += n;
-      continue;
-    }
-    int const base = idx;
-    for (int t = 1; t < n - 1; ++t) {
-      out.push_back(static_cast<Index>(face_vertex_indices[base]));
-      out.push_back(static_cast<Index>(face_vertex_indices[base + t]));
-      out.push_back(static_cast<Index>(face_vertex_indices[base + t + 1]));
-    }
-    idx += n;
-  }
-}
-
 static float lux_effective_intensity(float intensity, float exposure)
 {
   return intensity * std::pow(2.0f, exposure);
@@ -214,6 +212,78 @@ static void read_usd_lux_color_and_effective_intensity(
   effective_intensity = lux_effective_intensity(intensity, exposure);
 }
 
+/** Punctual light of any kind the importer maps UsdLux lights to. */
+using UsdLight = std::variant<DirectionalLight, PointLight, SpotLight>;
+
+/** Nothing for prims that are not lights and for lights without a punctual equivalent. */
+static std::optional<UsdLight> read_usd_light(UsdPrim const &prim)
+{
+  if (prim.IsA<UsdLuxDomeLight>()) {
+    // Environment domes do not map to punctual lights; skip.
+    return std::nullopt;
+  }
+  GfVec3f c;
+  float intensity;
+  if (prim.IsA<UsdLuxDistantLight>()) {
+    read_usd_lux_color_and_effective_intensity(prim, c, intensity);
+    return DirectionalLight(c[0], c[1], c[2], intensity);
+  }
+  if (prim.IsA<UsdLuxSphereLight>()) {
+    read_usd_lux_color_and_effective_intensity(prim, c, intensity);
+    UsdLuxShapingAPI shaping(prim);
+    float cone = 180.f;
+    if (shaping.GetShapingConeAngleAttr().Get(&cone) && cone > 0.f && cone < 179.f) {
+      float const outer = GfDegreesToRadians(cone);
+      return SpotLight(c[0], c[1], c[2], intensity, outer * 0.9f, outer);
+    }
+    return PointLight(c[0], c[1], c[2], intensity);
+  }
+  if (prim.IsA<UsdLuxDiskLight>() || prim.IsA<UsdLuxRectLight>() ||
+      prim.IsA<UsdLuxCylinderLight>()) {
+    read_usd_lux_color_and_effective_intensity(prim, c, intensity);
+    return PointLight(c[0], c[1], c[2], intensity);
+  }
+  return std::nullopt;
+}
+
+static void append_usd_light(Model::Lights &lights, UsdLight const &light)
+{
+  std::visit(
+      [&](auto const &l) {
+        using T = std::decay_t<decltype(l)>;
+        if constexpr (std::is_same_v<T, DirectionalLight>) {
+          lights.directionals.push_back(l);
+        }
+        else if constexpr (std::is_same_v<T, SpotLight>) {
+          lights.spots.push_back(l);
+        }
+        else {
+          lights.points.push_back(l);
+        }
+      },
+      light);
+}
+
+/** Camera intrinsics; `world_from_camera` is left for the caller to place. */
+static CameraData read_usd_camera(UsdGeomCamera const &cam)
+{
+  CameraData cd{};
+  cd.name = cam.GetPrim().GetName();
+  TfToken proj;
+  if (cam.GetProjectionAttr().Get(&proj)) {
+    cd.perspective = (proj == UsdGeomTokens->perspective);
+  }
+  cam.GetFocalLengthAttr().Get(&cd.focal_length_mm);
+  cam.GetHorizontalApertureAttr().Get(&cd.horizontal_aperture_mm);
+  cam.GetVerticalApertureAttr().Get(&cd.vertical_aperture_mm);
+  GfVec2f cr(0.01f, 1e6f);
+  if (cam.GetClippingRangeAttr().Get(&cr)) {
+    cd.clipping_range_near = cr[0];
+    cd.clipping_range_far = cr[1];
+  }
+  return cd;
+}
+
 static std::optional<TextureData> try_load_uv_texture(
     UsdShadeShader const &texShader, TextureType type, std::filesystem::path const &stage_dir,
     Options options)
@@ -350,20 +420,28 @@ static std::optional<UsdShadeShader> find_preview_surface(UsdShadeMaterial const
   return std::nullopt;
 }
 
-struct MeshGeometryScratch {
-  std::vector<Position> positions;
-  std::vector<int> face_vertex_counts;
-  std::vector<int> face_vertex_indices;
-  std::vector<float> normals_xyz;
-  std::vector<float> uv_xy;
+/**
+ * Geometry of one mesh prim as read from the stage. Vt arrays share the composed values
+ * copy-on-write, so nothing is copied until the data lands in its final Mesh storage.
+ */
+struct UsdMeshArrays {
+  UsdTimeCode time = UsdTimeCode::Default(); // Frame 0 of the import
+  VtVec3fArray points;
+  VtIntArray face_vertex_counts;
+  VtIntArray face_vertex_indices;
+  VtVec3fArray normals; // Per point or per face corner, or empty
+  VtVec2fArray uvs; // Per point or per face corner, or empty
+  bool normals_per_corner = false;
+  bool uvs_per_corner = false;
 };
 
 struct MeshBuildItem {
   UsdGeomMesh mesh;
-  GfMatrix4d world;
+  std::vector<GfMatrix4d> worlds; // One per instance of the mesh
+  std::vector<AffineTransform> animated_transforms; // Frame-major, frames 1.., empty if static
   std::string name;
   size_t material_index = 0;
-  MeshGeometryScratch scratch;
+  UsdMeshArrays arrays;
   bool geom_ok = false;
 };
 
@@ -381,161 +459,567 @@ static bool usd_geom_mesh_is_guide_purpose(UsdGeomMesh const &gm)
   return purpose == UsdGeomTokens->guide;
 }
 
+/**
+ * Flattened values of `primvar` per point or per face corner. Indexed primvars are expanded,
+ * uniform values are repeated per corner and constant values per point.
+ * Returns false when the primvar does not fit the mesh topology.
+ */
+template <typename T>
+static bool read_mesh_primvar(UsdGeomPrimvar const &primvar,
+    UsdMeshArrays const &arrays,
+    VtArray<T> &values,
+    bool &per_corner)
+{
+  if (!primvar.ComputeFlattened(&values, arrays.time)) {
+    return false;
+  }
+
+  TfToken const interpolation = primvar.GetInterpolation();
+  if (interpolation == UsdGeomTokens->faceVarying) {
+    per_corner = true;
+    return values.size() == arrays.face_vertex_indices.size();
+  }
+  if (interpolation == UsdGeomTokens->uniform) {
+    if (values.size() != arrays.face_vertex_counts.size()) {
+      return false;
+    }
+    VtArray<T> expanded(arrays.face_vertex_indices.size());
+    size_t corner = 0;
+    for (size_t f = 0; f < arrays.face_vertex_counts.size(); ++f) {
+      for (int k = 0; k < arrays.face_vertex_counts[f]; ++k) {
+        expanded[corner++] = values[f];
+      }
+    }
+    values.swap(expanded);
+    per_corner = true;
+    return true;
+  }
+  per_corner = false;
+  if (interpolation == UsdGeomTokens->constant) {
+    if (values.size() != 1) {
+      return false;
+    }
+    values = VtArray<T>(arrays.points.size(), values[0]);
+    return true;
+  }
+  // vertex and varying
+  return values.size() == arrays.points.size();
+}
+
 static bool extract_usd_mesh_geometry(
-    UsdGeomMesh const &geom, MeshGeometryScratch &scratch, Options options)
+    UsdGeomMesh const &geom, UsdTimeCode time, UsdMeshArrays &arrays, Options options)
 {
   ZoneScopedN("USD extract mesh");
-  const UsdTimeCode time = UsdTimeCode::Default();
-  VtVec3fArray points;
-  bool const pts_ok = geom.GetPointsAttr().Get(&points, time);
-  if (!pts_ok || points.empty()) {
+  arrays.time = time;
+  bool const pts_ok = geom.GetPointsAttr().Get(&arrays.points, time);
+  if (!pts_ok || arrays.points.empty()) {
     return false;
   }
-  VtIntArray faceVertexCounts;
-  VtIntArray faceVertexIndices;
-  if (!geom.GetFaceVertexCountsAttr().Get(&faceVertexCounts, time) ||
-      !geom.GetFaceVertexIndicesAttr().Get(&faceVertexIndices, time)) {
+  if (!geom.GetFaceVertexCountsAttr().Get(&arrays.face_vertex_counts, time) ||
+      !geom.GetFaceVertexIndicesAttr().Get(&arrays.face_vertex_indices, time)) {
     return false;
   }
 
-  scratch.positions.clear();
-  scratch.positions.reserve(points.size());
-  for (GfVec3f const &p : points) {
-    scratch.positions.push_back(Position{p[0], p[1], p[2]});
-  }
-  scratch.face_vertex_counts.assign(
-      faceVertexCounts.cdata(), faceVertexCounts.cdata() + faceVertexCounts.size());
-  scratch.face_vertex_indices.assign(
-      faceVertexIndices.cdata(), faceVertexIndices.cdata() + faceVertexIndices.size());
-
-  if (scratch.face_vertex_counts.empty()) {
+  if (arrays.face_vertex_counts.empty()) {
     return false;
   }
   long long corner_sum = 0;
-  for (int c : scratch.face_vertex_counts) {
+  for (int c : arrays.face_vertex_counts) {
     if (c < 0) {
       return false;
     }
     corner_sum += c;
   }
-  if (corner_sum != static_cast<long long>(scratch.face_vertex_indices.size())) {
+  if (corner_sum != static_cast<long long>(arrays.face_vertex_indices.size())) {
     return false;
   }
 
-  size_t const nv = scratch.positions.size();
-  for (int vi : scratch.face_vertex_indices) {
+  size_t const nv = arrays.points.size();
+  for (int vi : arrays.face_vertex_indices) {
     if (vi < 0 || static_cast<size_t>(vi) >= nv) {
       return false;
     }
   }
 
-  scratch.normals_xyz.clear();
-  scratch.uv_xy.clear();
+  arrays.normals.clear();
+  arrays.uvs.clear();
 
   if (is_enabled(options, Options::LoadMeshAttributes)) {
     UsdGeomPrimvarsAPI pvapi(geom.GetPrim());
     UsdGeomPrimvar nvar = pvapi.GetPrimvar(TfToken("normals"));
-    if (nvar.HasValue()) {
-      VtVec3fArray normals;
-      if (nvar.Get(&normals, time) && normals.size() == points.size()) {
-        scratch.normals_xyz.resize(normals.size() * 3u);
-        for (size_t i = 0; i < normals.size(); ++i) {
-          scratch.normals_xyz[i * 3 + 0] = normals[i][0];
-          scratch.normals_xyz[i * 3 + 1] = normals[i][1];
-          scratch.normals_xyz[i * 3 + 2] = normals[i][2];
-        }
-      }
+    if (nvar.HasValue() &&
+        !read_mesh_primvar(nvar, arrays, arrays.normals, arrays.normals_per_corner)) {
+      arrays.normals.clear();
     }
     UsdGeomPrimvar uvvar = pvapi.GetPrimvar(TfToken("st"));
     if (!uvvar || !uvvar.HasValue()) {
       uvvar = pvapi.GetPrimvar(TfToken("uv"));
     }
-    if (uvvar.HasValue()) {
-      VtVec2fArray uvs;
-      if (uvvar.Get(&uvs, time) && uvs.size() == points.size()) {
-        scratch.uv_xy.resize(uvs.size() * 2u);
-        for (size_t i = 0; i < uvs.size(); ++i) {
-          scratch.uv_xy[i * 2 + 0] = uvs[i][0];
-          scratch.uv_xy[i * 2 + 1] = uvs[i][1];
+    if (uvvar.HasValue() && !read_mesh_primvar(uvvar, arrays, arrays.uvs, arrays.uvs_per_corner)) {
+      arrays.uvs.clear();
+    }
+  }
+  return true;
+}
+
+/** Copy `count` packed `N`-float elements into `dst`, element `i` at `dst + i * dst_stride`. */
+template <size_t N>
+static void copy_strided_floats(float const *src, size_t count, std::byte *dst, size_t dst_stride)
+{
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count, size_t{1} << 14),
+      [&](tbb::blocked_range<size_t> const &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          std::memcpy(dst + i * dst_stride, src + i * N, N * sizeof(float));
         }
-      }
+      });
+}
+
+/** Corner and triangle offsets of a face in faceVertexIndices and the triangulated output. */
+struct FaceOffsets {
+  size_t corners = 0;
+  size_t triangles = 0;
+};
+
+/** Newell normal of the polygon through `points`, robust for non-planar and concave faces. */
+static GfVec3f face_normal(GfVec3f const *points, int const *corners, int n)
+{
+  GfVec3f normal(0.f);
+  for (int i = 0; i < n; ++i) {
+    GfVec3f const &p = points[corners[i]];
+    GfVec3f const &q = points[corners[(i + 1) % n]];
+    normal[0] += (p[1] - q[1]) * (p[2] + q[2]);
+    normal[1] += (p[2] - q[2]) * (p[0] + q[0]);
+    normal[2] += (p[0] - q[0]) * (p[1] + q[1]);
+  }
+  return normal;
+}
+
+static bool is_convex_face(GfVec3f const *points, int const *corners, int n, GfVec3f const &normal)
+{
+  for (int i = 0; i < n; ++i) {
+    GfVec3f const &prev = points[corners[(i + n - 1) % n]];
+    GfVec3f const &cur = points[corners[i]];
+    GfVec3f const &next = points[corners[(i + 1) % n]];
+    if (GfDot(GfCross(cur - prev, next - cur), normal) < 0.f) {
+      return false;
     }
   }
   return true;
 }
 
-static void finalize_mesh_from_scratch(
-    MeshGeometryScratch const &scratch, Mesh &mesh, bool load_attributes, Options options)
+/**
+ * Ear-clip a concave face into its n - 2 triangles of face-corner indices `base + k`.
+ * The face is projected onto the axis plane its normal is closest to, and winding follows the
+ * face. Degenerate leftovers (no ear found) are fanned so the triangle count stays exact.
+ */
+static void ear_clip_face(GfVec3f const *points,
+    int const *corners,
+    int n,
+    GfVec3f const &normal,
+    Index base,
+    Index *out)
+{
+  int axis = 0;
+  for (int a = 1; a < 3; ++a) {
+    if (std::abs(normal[a]) > std::abs(normal[axis])) {
+      axis = a;
+    }
+  }
+  int const u = (axis + 1) % 3;
+  int const v = (axis + 2) % 3;
+  // Projection along a negative axis mirrors the polygon
+  double const orientation = normal[axis] < 0.f ? -1.0 : 1.0;
+
+  std::vector<std::array<double, 2>> uv(n);
+  for (int i = 0; i < n; ++i) {
+    GfVec3f const &p = points[corners[i]];
+    uv[i] = {p[u], p[v]};
+  }
+  auto const cross = [&](int a, int b, int c) {
+    return orientation * ((uv[b][0] - uv[a][0]) * (uv[c][1] - uv[a][1]) -
+                             (uv[b][1] - uv[a][1]) * (uv[c][0] - uv[a][0]));
+  };
+
+  std::vector<int> ring(n);
+  std::iota(ring.begin(), ring.end(), 0);
+  auto const emit = [&](int a, int b, int c) {
+    *out++ = base + static_cast<Index>(a);
+    *out++ = base + static_cast<Index>(b);
+    *out++ = base + static_cast<Index>(c);
+  };
+
+  while (ring.size() > 3) {
+    size_t const m = ring.size();
+    bool clipped = false;
+    for (size_t i = 0; i < m && !clipped; ++i) {
+      int const a = ring[(i + m - 1) % m];
+      int const b = ring[i];
+      int const c = ring[(i + 1) % m];
+      if (cross(a, b, c) <= 0.0) {
+        continue; // Reflex or degenerate corner
+      }
+      bool contains_other = false;
+      for (int const p : ring) {
+        if (p != a && p != b && p != c && cross(a, b, p) >= 0.0 && cross(b, c, p) >= 0.0 &&
+            cross(c, a, p) >= 0.0) {
+          contains_other = true;
+          break;
+        }
+      }
+      if (!contains_other) {
+        emit(a, b, c);
+        ring.erase(ring.begin() + static_cast<std::ptrdiff_t>(i));
+        clipped = true;
+      }
+    }
+    if (!clipped) {
+      break;
+    }
+  }
+  for (size_t i = 1; i + 1 < ring.size(); ++i) {
+    emit(ring[0], ring[i], ring[i + 1]);
+  }
+}
+
+/**
+ * Triangulate all faces into face-corner indices (positions in faceVertexIndices).
+ *
+ * A parallel prefix sum over faceVertexCounts gives every face its slot in the preallocated
+ * output, then faces are triangulated in parallel chunks straight into place. Triangles and
+ * convex faces are fanned; only concave faces pay for ear clipping.
+ */
+static void triangulate_faces(UsdMeshArrays const &arrays, IndexArray &out)
+{
+  ZoneScopedN("USD triangulate");
+  int const *const counts = arrays.face_vertex_counts.cdata();
+  int const *const corners = arrays.face_vertex_indices.cdata();
+  GfVec3f const *const points = arrays.points.cdata();
+  size_t const nfaces = arrays.face_vertex_counts.size();
+  constexpr size_t grain = size_t{1} << 14;
+
+  std::vector<FaceOffsets> offsets(nfaces);
+  FaceOffsets const total = tbb::parallel_scan(
+      tbb::blocked_range<size_t>(0, nfaces, grain),
+      FaceOffsets{},
+      [&](tbb::blocked_range<size_t> const &range, FaceOffsets sum, bool is_final) {
+        for (size_t f = range.begin(); f < range.end(); ++f) {
+          if (is_final) {
+            offsets[f] = sum;
+          }
+          size_t const n = static_cast<size_t>(counts[f]);
+          sum.corners += n;
+          sum.triangles += n >= 3 ? n - 2 : 0;
+        }
+        return sum;
+      },
+      [](FaceOffsets const &lhs, FaceOffsets const &rhs) {
+        return FaceOffsets{lhs.corners + rhs.corners, lhs.triangles + rhs.triangles};
+      });
+
+  out.resize(total.triangles * 3);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, nfaces, grain),
+      [&](tbb::blocked_range<size_t> const &range) {
+        for (size_t f = range.begin(); f < range.end(); ++f) {
+          int const n = counts[f];
+          if (n < 3) {
+            continue;
+          }
+          Index const base = static_cast<Index>(offsets[f].corners);
+          Index *dst = out.data() + offsets[f].triangles * 3;
+          if (n > 3) {
+            int const *const face = corners + offsets[f].corners;
+            GfVec3f const normal = face_normal(points, face, n);
+            if (!is_convex_face(points, face, n, normal)) {
+              ear_clip_face(points, face, n, normal, base, dst);
+              continue;
+            }
+          }
+          for (int t = 1; t < n - 1; ++t) {
+            *dst++ = base;
+            *dst++ = base + static_cast<Index>(t);
+            *dst++ = base + static_cast<Index>(t + 1);
+          }
+        }
+      });
+}
+
+/** One vertex per point, attributes are per point. Maps corner indices to point indices. */
+static void build_point_vertices(
+    UsdMeshArrays const &arrays, Mesh &mesh, bool has_normals, bool has_uvs)
+{
+  static_assert(sizeof(GfVec3f) == sizeof(Position) && sizeof(GfVec2f) == 2 * sizeof(float));
+
+  size_t const n = arrays.points.size();
+  mesh.positions.resize(n);
+  std::memcpy(mesh.positions.data(), arrays.points.cdata(), n * sizeof(Position));
+
+  int const *const face_vertex_indices = arrays.face_vertex_indices.cdata();
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, mesh.indices.size(), size_t{1} << 14),
+      [&](tbb::blocked_range<size_t> const &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          mesh.indices[i] = static_cast<Index>(face_vertex_indices[mesh.indices[i]]);
+        }
+      });
+
+  if (has_normals || has_uvs) {
+    mesh.attributes.resize(n);
+  }
+  std::byte *const attributes_data = reinterpret_cast<std::byte *>(mesh.attributes.data());
+  if (has_normals) {
+    mesh.attributes.is_normal_present = true;
+    copy_strided_floats<3>(arrays.normals.cdata()->data(),
+        n,
+        attributes_data + offsetof(VertexAttributes, normal),
+        sizeof(VertexAttributes));
+  }
+  if (has_uvs) {
+    mesh.attributes.is_texcoord_present = true;
+    copy_strided_floats<2>(arrays.uvs.cdata()->data(),
+        n,
+        attributes_data + offsetof(VertexAttributes, texcoord),
+        sizeof(VertexAttributes));
+  }
+}
+
+/**
+ * One vertex per distinct (point, faceVarying attributes) corner. Every corner is split into
+ * its own vertex and identical ones are welded back, so a cube with faceted normals ends up
+ * with 24 vertices rather than 8 (wrong shading) or 36 (no sharing).
+ * Identical corners always share their point, so corners are sorted in parallel by point and
+ * then by their per-corner attributes; every run of equal corners becomes one vertex, and
+ * vertices are numbered by point. Maps corner indices to welded vertex indices and records
+ * the point of every vertex.
+ */
+static void build_corner_vertices(UsdMeshArrays const &arrays,
+    Mesh &mesh,
+    bool has_normals,
+    bool has_uvs,
+    std::vector<uint32_t> &vertex_points)
+{
+  size_t const corners = arrays.face_vertex_indices.size();
+  constexpr size_t grain = size_t{1} << 14;
+  int const *const fvi = arrays.face_vertex_indices.cdata();
+
+  // Per-point attributes follow from the point index, only per-corner ones are compared
+  GfVec3f const *const corner_normals =
+      has_normals && arrays.normals_per_corner ? arrays.normals.cdata() : nullptr;
+  GfVec2f const *const corner_uvs =
+      has_uvs && arrays.uvs_per_corner ? arrays.uvs.cdata() : nullptr;
+  // Bitwise, like a hash weld: -0.0 and 0.0 stay apart, identical NaNs merge
+  auto const compare_attributes = [&](uint32_t a, uint32_t b) {
+    int order = corner_normals
+        ? std::memcmp(&corner_normals[a], &corner_normals[b], sizeof(GfVec3f))
+        : 0;
+    if (order == 0 && corner_uvs) {
+      order = std::memcmp(&corner_uvs[a], &corner_uvs[b], sizeof(GfVec2f));
+    }
+    return order;
+  };
+
+  std::vector<uint32_t> sorted(corners);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, corners, grain),
+      [&](tbb::blocked_range<size_t> const &range) {
+        for (size_t c = range.begin(); c < range.end(); ++c) {
+          sorted[c] = static_cast<uint32_t>(c);
+        }
+      });
+  // Ties are broken by corner index, so the numbering does not depend on the schedule
+  tbb::parallel_sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+    if (fvi[a] != fvi[b]) {
+      return fvi[a] < fvi[b];
+    }
+    int const order = compare_attributes(a, b);
+    return order != 0 ? order < 0 : a < b;
+  });
+
+  // A corner starts a vertex unless it equals the previous corner of the sorted order
+  std::vector<unsigned int> remap(corners);
+  std::vector<uint32_t> first_corner(corners); // Trimmed to the vertex count below
+  auto const starts_vertex = [&](size_t i) {
+    return i == 0 || fvi[sorted[i - 1]] != fvi[sorted[i]] ||
+        compare_attributes(sorted[i - 1], sorted[i]) != 0;
+  };
+  size_t const vertex_count = tbb::parallel_scan(
+      tbb::blocked_range<size_t>(0, corners, grain),
+      size_t{0},
+      [&](tbb::blocked_range<size_t> const &range, size_t vertices, bool is_final) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          if (starts_vertex(i)) {
+            if (is_final) {
+              first_corner[vertices] = sorted[i];
+            }
+            ++vertices;
+          }
+          if (is_final) {
+            remap[sorted[i]] = static_cast<unsigned int>(vertices - 1);
+          }
+        }
+        return vertices;
+      },
+      std::plus<size_t>());
+  first_corner.resize(vertex_count);
+
+  mesh.positions.resize(vertex_count);
+  vertex_points.resize(vertex_count);
+  if (has_normals || has_uvs) {
+    mesh.attributes.resize(vertex_count);
+    mesh.attributes.is_normal_present = has_normals;
+    mesh.attributes.is_texcoord_present = has_uvs;
+  }
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, vertex_count, grain),
+      [&](tbb::blocked_range<size_t> const &range) {
+        for (size_t v = range.begin(); v < range.end(); ++v) {
+          size_t const c = first_corner[v];
+          size_t const point = static_cast<size_t>(arrays.face_vertex_indices[c]);
+          GfVec3f const &p = arrays.points[point];
+          mesh.positions[v] = {p[0], p[1], p[2]};
+          vertex_points[v] = static_cast<uint32_t>(point);
+          if (has_normals) {
+            GfVec3f const &n = arrays.normals[arrays.normals_per_corner ? c : point];
+            mesh.attributes[v].normal = {n[0], n[1], n[2]};
+          }
+          if (has_uvs) {
+            GfVec2f const &t = arrays.uvs[arrays.uvs_per_corner ? c : point];
+            mesh.attributes[v].texcoord = {t[0], t[1]};
+          }
+        }
+      });
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, mesh.indices.size(), grain),
+      [&](tbb::blocked_range<size_t> const &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          mesh.indices[i] = remap[mesh.indices[i]];
+        }
+      });
+}
+
+/** `vertex_points` receives the USD point of every vertex, or stays empty when they match. */
+static void build_mesh_from_usd_arrays(UsdMeshArrays const &arrays,
+    Mesh &mesh,
+    bool load_attributes,
+    Options options,
+    std::vector<uint32_t> &vertex_points)
 {
   ZoneScopedN("USD finalize mesh");
-  mesh.positions = scratch.positions;
-  triangulate_faces_from_counts(scratch.face_vertex_counts.data(),
-      scratch.face_vertex_counts.size(),
-      scratch.face_vertex_indices.data(),
-      mesh.indices);
+
+  triangulate_faces(arrays, mesh.indices);
   if (mesh.indices.empty()) {
     mesh = Mesh{};
     return;
   }
 
+  bool const load = load_attributes && is_enabled(options, Options::LoadMeshAttributes);
+  bool const has_normals = load && !arrays.normals.empty();
+  bool const has_uvs = load && !arrays.uvs.empty();
+  if ((has_normals && arrays.normals_per_corner) || (has_uvs && arrays.uvs_per_corner)) {
+    build_corner_vertices(arrays, mesh, has_normals, has_uvs, vertex_points);
+  }
+  else {
+    build_point_vertices(arrays, mesh, has_normals, has_uvs);
+  }
+
   mesh.lods.clear();
   // IndexArray owns triangle indices; LOD[0] only references the same storage.
   mesh.lods.emplace_back(IndexSpan(mesh.indices.data(), mesh.indices.size()), IndexSpan());
 
-  if (load_attributes && is_enabled(options, Options::LoadMeshAttributes)) {
-    size_t const n = mesh.positions.size();
-    if (!scratch.normals_xyz.empty() && scratch.normals_xyz.size() == n * 3) {
-      mesh.attributes.resize(n);
-      mesh.attributes.is_normal_present = true;
-      for (size_t i = 0; i < n; ++i) {
-        mesh.attributes[i].normal = {scratch.normals_xyz[i * 3 + 0],
-            scratch.normals_xyz[i * 3 + 1],
-            scratch.normals_xyz[i * 3 + 2]};
-      }
+  update_mesh_bounds(mesh);
+}
+
+/** Time codes of `range`, nothing for an empty or malformed range. */
+static std::vector<double> usd_sample_times(std::optional<UsdTimeRange> const &range)
+{
+  std::vector<double> times;
+  if (!range.has_value()) {
+    return times;
+  }
+  if (!(range->step > 0.0) || range->end < range->start) {
+    MR_WARNING("USD: ignoring time range [{}, {}] with step {}",
+        range->start,
+        range->end,
+        range->step);
+    return times;
+  }
+  // Tolerate rounding in (end - start) / step so the end frame is not lost
+  size_t const frames =
+      static_cast<size_t>(std::floor((range->end - range->start) / range->step + 1e-6));
+  times.reserve(frames + 1);
+  for (size_t f = 0; f <= frames; ++f) {
+    times.push_back(range->start + static_cast<double>(f) * range->step);
+  }
+  return times;
+}
+
+/**
+ * Sample the points of `geom` at `times[1..]` into `mesh.animation` as 16-bit deltas against
+ * frame 0 (`base_points`, already in `mesh.positions`). Frames are read twice, once for the
+ * per-axis delta range and once to quantize, so no float copy of the whole cache is kept.
+ * Meshes whose point count changes over time keep only frame 0.
+ */
+static void sample_usd_point_animation(UsdGeomMesh const &geom,
+    std::vector<double> const &times,
+    VtVec3fArray const &base_points,
+    std::vector<uint32_t> const &vertex_points,
+    Mesh &mesh)
+{
+  ZoneScopedN("USD sample point animation");
+  if (times.size() < 2 || !geom.GetPointsAttr().ValueMightBeTimeVarying()) {
+    return;
+  }
+
+  size_t const frames = times.size() - 1;
+  size_t const point_count = base_points.size();
+  std::vector<GfVec3f> frame_range(frames, GfVec3f(0.f));
+  std::atomic<bool> consistent = true;
+  tbb::parallel_for(size_t{0}, frames, [&](size_t f) {
+    VtVec3fArray points;
+    if (!geom.GetPointsAttr().Get(&points, times[f + 1]) || points.size() != point_count) {
+      consistent = false;
+      return;
     }
-    if (!scratch.uv_xy.empty() && scratch.uv_xy.size() == n * 2) {
-      if (mesh.attributes.size() != n) {
-        mesh.attributes.resize(n);
-      }
-      mesh.attributes.is_texcoord_present = true;
-      for (size_t i = 0; i < n; ++i) {
-        mesh.attributes[i].texcoord = {scratch.uv_xy[i * 2 + 0], scratch.uv_xy[i * 2 + 1]};
+    for (size_t p = 0; p < point_count; ++p) {
+      GfVec3f const delta = points[p] - base_points[p];
+      for (int axis = 0; axis < 3; ++axis) {
+        frame_range[f][axis] = std::max(frame_range[f][axis], std::abs(delta[axis]));
       }
     }
+  });
+  if (!consistent) {
+    MR_WARNING("USD: {} changes point count over time, importing frame 0 only",
+        geom.GetPath().GetString());
+    return;
   }
 
-  if (mesh.positions.empty()) {
+  GfVec3f range(0.f);
+  for (GfVec3f const &r : frame_range) {
+    range = GfVec3f(std::max(range[0], r[0]), std::max(range[1], r[1]), std::max(range[2], r[2]));
+  }
+  if (range == GfVec3f(0.f)) {
     return;
   }
 
-  auto min_pos = mesh.positions[0];
-  auto max_pos = mesh.positions[0];
-  for (const auto &pos : mesh.positions) {
-    min_pos[0] = std::min(min_pos[0], pos[0]);
-    min_pos[1] = std::min(min_pos[1], pos[1]);
-    min_pos[2] = std::min(min_pos[2], pos[2]);
-    max_pos[0] = std::max(max_pos[0], pos[0]);
-    max_pos[1] = std::max(max_pos[1], pos[1]);
-    max_pos[2] = std::max(max_pos[2], pos[2]);
+  MeshAnimation &animation = mesh.animation;
+  GfVec3f inverse_scale;
+  for (int axis = 0; axis < 3; ++axis) {
+    animation.delta_scale[axis] = range[axis] / 32767.f;
+    inverse_scale[axis] = range[axis] > 0.f ? 32767.f / range[axis] : 0.f;
   }
-  mesh.aabb.min = {min_pos[0], min_pos[1], min_pos[2]};
-  mesh.aabb.max = {max_pos[0], max_pos[1], max_pos[2]};
 
-  mr::Vec3f c(0, 0, 0);
-  for (auto const &p : mesh.positions) {
-    c += mr::Vec3f(p[0], p[1], p[2]);
-  }
-  float const inv_n = 1.f / static_cast<float>(mesh.positions.size());
-  c = mr::Vec3f(c.x() * inv_n, c.y() * inv_n, c.z() * inv_n);
-  float r2 = 0.f;
-  for (auto const &p : mesh.positions) {
-    float const dx = p[0] - c.x();
-    float const dy = p[1] - c.y();
-    float const dz = p[2] - c.z();
-    r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
-  }
-  mesh.bounding_sphere.center(c);
-  mesh.bounding_sphere.radius(std::sqrt(r2));
+  size_t const vertex_count = mesh.positions.size();
+  animation.position_deltas.resize(frames * vertex_count);
+  tbb::parallel_for(size_t{0}, frames, [&](size_t f) {
+    VtVec3fArray points;
+    geom.GetPointsAttr().Get(&points, times[f + 1]);
+    MeshAnimation::QuantizedDelta *const deltas =
+        animation.position_deltas.data() + f * vertex_count;
+    for (size_t v = 0; v < vertex_count; ++v) {
+      size_t const p = vertex_points.empty() ? v : vertex_points[v];
+      GfVec3f const delta = points[p] - base_points[p];
+      for (int axis = 0; axis < 3; ++axis) {
+        float const q = std::round(delta[axis] * inverse_scale[axis]);
+        deltas[v][axis] = static_cast<std::int16_t>(std::clamp(q, -32767.f, 32767.f));
+      }
+    }
+  });
 }
 
 static std::filesystem::path resolve_usd_asset_path(std::filesystem::path const &path)
@@ -553,7 +1037,22 @@ static std::filesystem::path resolve_usd_asset_path(std::filesystem::path const
   return path;
 }
 
-static UsdStageRefPtr open_usd_stage_from_path(std::filesystem::path const &path)
+/** Absolute prim paths out of `paths`, warning about and skipping the rest. */
+static SdfPathSet parse_usd_prim_paths(std::vector<std::string> const &paths)
+{
+  SdfPathSet result;
+  for (std::string const &p : paths) {
+    if (!SdfPath::IsValidPathString(p) || !SdfPath(p).IsAbsoluteRootOrPrimPath()) {
+      MR_WARNING("USD: ignoring invalid prim path '{}' in import filter", p);
+      continue;
+    }
+    result.insert(SdfPath(p));
+  }
+  return result;
+}
+
+static UsdStageRefPtr open_usd_stage_from_path(
+    std::filesystem::path const &path, UsdImportFilter const &filter)
 {
   ZoneScopedN("open_usd_stage_from_path");
   ensure_usd_plugins_registered();
@@ -561,206 +1060,698 @@ static UsdStageRefPtr open_usd_stage_from_path(std::filesystem::path const &path
   // sublayers, and nested payloads resolve against the asset directory.
   std::string const p = path.string();
   ArResolverContext const ctx = ArGetResolver().CreateDefaultContextForAsset(p);
-  return UsdStage::Open(p, ctx);
+  // With deferred payloads nothing is loaded while the stage composes; the caller loads the
+  // requested payloads in one batch
+  UsdStage::InitialLoadSet const load =
+      filter.payload_paths.has_value() ? UsdStage::LoadNone : UsdStage::LoadAll;
+  if (filter.prim_paths.empty()) {
+    return UsdStage::Open(p, ctx, load);
+  }
+
+  UsdStagePopulationMask mask;
+  for (SdfPath const &prim_path : parse_usd_prim_paths(filter.prim_paths)) {
+    mask.Add(prim_path);
+  }
+  if (mask.IsEmpty()) {
+    // Nothing valid was requested; an empty mask would compose nothing at all
+    return nullptr;
+  }
+  return UsdStage::OpenMasked(p, ctx, mask, load);
 }
 
-static bool load_usd_into_model(Model &model, std::filesystem::path const &path, Options options)
+/** Bring the payloads the filter asks for into the stage's load set. */
+static void load_usd_payloads(UsdStageRefPtr const &stage, UsdImportFilter const &filter)
 {
-  ZoneScopedN("load_usd_into_model");
-
-  std::filesystem::path const asset_path = resolve_usd_asset_path(path);
-  UsdStageRefPtr stage = open_usd_stage_from_path(asset_path);
-  if (!stage) {
-    MR_ERROR("Failed to open USD stage: {}", asset_path.string());
-    return false;
+  ZoneScopedN("USD load payloads");
+  if (!filter.payload_paths.has_value()) {
+    // Nested payloads (e.g. prefab → .gdt.usd → variant → .geo.usd) must be in the
+    // load set or composition stops at empty payload gates (0 meshes).
+    stage->Load(SdfPath::AbsoluteRootPath(), UsdLoadWithDescendants);
+    return;
+  }
+  SdfPathSet const load_set = parse_usd_prim_paths(*filter.payload_paths);
+  if (!load_set.empty()) {
+    stage->LoadAndUnload(load_set, SdfPathSet(), UsdLoadWithDescendants);
   }
+}
 
-  // Nested payloads (e.g. prefab → .gdt.usd → variant → .geo.usd) must be in the
-  // load set or composition stops at empty payload gates (0 meshes).
-  stage->Load(SdfPath::AbsoluteRootPath(), UsdLoadWithDescendants);
+/** A point instancer instance a placement is reached through. */
+struct InstancerHop {
+  SdfPath instancer;
+  SdfPath prototype; // Prototype root under the instancer
+  size_t instance;
+};
 
-  GfMatrix4d upCorr = stage_up_axis_correction(stage);
-  std::filesystem::path stage_dir = asset_path.parent_path();
+/** A scene object reachable from an instancing root, with its transform into the root's frame. */
+struct ScenePlacement {
+  enum class Kind { Mesh, Light, Camera };
 
-  std::unordered_map<std::string, size_t> material_index_by_path;
-  std::mutex material_mutex;
+  Kind kind;
+  size_t index; // Into mesh_prims(), lights() or cameras()
+  GfMatrix4d to_root;
+  SdfPath path; // Under the root; inside scenegraph instances this is an instance proxy path
+  std::vector<InstancerHop> instancers; // Innermost first, empty outside point instancers
+};
 
-  auto ensure_material = [&](UsdShadeMaterial const &mat) -> size_t {
-    std::string key = mat.GetPath().GetString();
-    std::lock_guard lock(material_mutex);
-    auto it = material_index_by_path.find(key);
-    if (it != material_index_by_path.end()) {
-      return it->second;
-    }
-    size_t idx = model.materials.size();
-    material_index_by_path[key] = idx;
-    MaterialData md{};
-    md.constants.base_color_factor = Color(0.8f, 0.8f, 0.8f, 1.f);
-    if (is_enabled(options, Options::LoadMaterials)) {
-      if (auto preview = find_preview_surface(mat)) {
-        md = build_material_from_preview(*preview, stage_dir, options);
-      }
-    }
-    model.materials.push_back(std::move(md));
-    return idx;
-  };
+/**
+ * A mesh placement whose world transform may change over time. Evaluating the path's world
+ * transform and then, per hop, mapping prototype root -> instance -> instancer rebuilds the
+ * placement at any time code without walking the stage again.
+ */
+struct AnimatedPlacement {
+  size_t item;
+  size_t instance; // Into MeshBuildItem::worlds
+  SdfPath path;
+  std::vector<InstancerHop> instancers;
+};
 
-  if (model.materials.empty()) {
-    MaterialData default_m{};
-    default_m.constants.base_color_factor = Color(1, 1, 1, 1);
-    model.materials.push_back(std::move(default_m));
+/**
+ * Single traversal of the composed stage, dispatching each prim by type.
+ *
+ * Materials are resolved as they are met; meshes, lights and cameras are recorded once and
+ * placed through instancing. Scenegraph instances and UsdGeomPointInstancer prototypes are
+ * walked once per prototype; their contents are memoized and re-placed for every instance,
+ * so a set of 100k instanced rocks yields one mesh prim with 100k placements. World
+ * matrices come from a UsdGeomXformCache, so ancestors are evaluated once rather than per prim.
+ * Placements inside instances keep their instance proxy path, so bindings authored on the
+ * instance or its ancestors can still be resolved per placement.
+ */
+class UsdSceneCollector {
+public:
+  using MaterialResolver = std::function<size_t(UsdShadeMaterial const &)>;
+
+  UsdSceneCollector(MaterialResolver resolve_material, UsdTimeCode time = UsdTimeCode::Default())
+    : resolve_material_(std::move(resolve_material)), time_(time), xform_cache_(time)
+  {
   }
 
+  /** Scene objects under `root` (including nested instances) in the frame of `root`. */
+  std::vector<ScenePlacement> const &collect(UsdPrim const &root)
   {
-    ZoneScopedN("USD traverse materials");
-    for (UsdPrim const &prim : stage->Traverse(UsdTraverseInstanceProxies())) {
-      if (prim.GetTypeName() != TfToken("Material")) {
+    auto const cached = contents_.find(root.GetPath());
+    if (cached != contents_.end()) {
+      return cached->second;
+    }
+
+    std::vector<ScenePlacement> contents;
+    GfMatrix4d const root_inverse = local_to_world(root).GetInverse();
+
+    UsdPrimRange range(root);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+      UsdPrim const &prim = *it;
+      if (prim.IsInstance()) {
+        // Contents of the prototype in the instance's frame
+        GfMatrix4d const to_root = local_to_world(prim) * root_inverse;
+        UsdPrim const prototype = prim.GetPrototype();
+        SdfPath const &prototype_path = prototype.GetPath();
+        for (ScenePlacement const &placement : collect(prototype)) {
+          ScenePlacement &placed = contents.emplace_back(placement);
+          placed.to_root = placement.to_root * to_root;
+          placed.path = placement.path.ReplacePrefix(prototype_path, prim.GetPath());
+          for (InstancerHop &hop : placed.instancers) {
+            hop.instancer = hop.instancer.ReplacePrefix(prototype_path, prim.GetPath());
+            hop.prototype = hop.prototype.ReplacePrefix(prototype_path, prim.GetPath());
+          }
+        }
+        it.PruneChildren();
         continue;
       }
-      UsdShadeMaterial mat(prim);
-      if (mat.GetPrim().IsValid()) {
-        ensure_material(mat);
+      if (prim.IsA<UsdGeomPointInstancer>()) {
+        append_point_instances(UsdGeomPointInstancer(prim), root_inverse, contents);
+        // Prototypes live under the instancer and are only drawn through it
+        it.PruneChildren();
+        continue;
+      }
+      if (prim.IsA<UsdGeomMesh>()) {
+        contents.push_back({ScenePlacement::Kind::Mesh,
+            mesh_index(prim),
+            local_to_world(prim) * root_inverse,
+            prim.GetPath()});
+      }
+      else if (prim.IsA<UsdShadeMaterial>()) {
+        resolve_material_(UsdShadeMaterial(prim));
+        // Shader networks hold nothing else to import
+        it.PruneChildren();
+      }
+      else if (prim.IsA<UsdGeomCamera>()) {
+        cameras_.push_back(read_usd_camera(UsdGeomCamera(prim)));
+        contents.push_back({ScenePlacement::Kind::Camera,
+            cameras_.size() - 1,
+            local_to_world(prim) * root_inverse,
+            prim.GetPath()});
+      }
+      else if (std::optional<UsdLight> light = read_usd_light(prim)) {
+        lights_.push_back(std::move(*light));
+        contents.push_back(
+            {ScenePlacement::Kind::Light, lights_.size() - 1, GfMatrix4d(1.0), prim.GetPath()});
       }
     }
+
+    return contents_.emplace(root.GetPath(), std::move(contents)).first->second;
   }
 
-  std::vector<MeshBuildItem> items;
+  /** Geometry prims of mesh placements; instanced meshes appear once, as prototype prims. */
+  std::vector<UsdPrim> const &mesh_prims() const { return mesh_prims_; }
+  std::vector<UsdLight> const &lights() const { return lights_; }
+  std::vector<CameraData> const &cameras() const { return cameras_; }
+
+  /**
+   * True when the world transform of `placement`, collected from the pseudo-root, may differ
+   * at another time code: some prim on its path or a point instancer it goes through is
+   * animated.
+   */
+  bool might_vary(UsdStagePtr const &stage, ScenePlacement const &placement)
   {
-    ZoneScopedN("USD collect meshes");
-    // Traverse the full composed stage (same as lights/cameras). Using only
-    // UsdPrimRange(defaultPrim) omits meshes outside the default prim subtree.
-    for (UsdPrim const &prim : stage->Traverse(UsdTraverseInstanceProxies())) {
-      if (!prim.IsA<UsdGeomMesh>()) {
-        continue;
-      }
-      UsdGeomMesh gm(prim);
-      UsdGeomXformable xf(prim);
-      GfMatrix4d world = xf.ComputeLocalToWorldTransform(UsdTimeCode::Default());
-      // Row-vector USD: p_w = p_l * W, then stage up-axis p' = p_w * U → combined p' = p_l * (W * U).
-      world = world * upCorr;
-
-      MeshBuildItem item;
-      item.mesh = gm;
-      item.world = world;
-      item.name = prim.GetName();
-
-      UsdShadeMaterialBindingAPI bindingAPI(prim);
-      UsdShadeMaterial mat = bindingAPI.ComputeBoundMaterial();
-      if (mat.GetPrim().IsValid()) {
-        item.material_index = ensure_material(mat);
-      }
-      items.push_back(std::move(item));
+    if (prim_might_vary(stage->GetPrimAtPath(placement.path))) {
+      return true;
     }
+    return std::any_of(placement.instancers.begin(),
+        placement.instancers.end(),
+        [&](InstancerHop const &hop) { return instancer_might_vary(stage, hop.instancer); });
   }
 
-  bool const any_non_guide = std::any_of(items.begin(), items.end(), [](MeshBuildItem const &it) {
-    return !usd_geom_mesh_is_guide_purpose(it.mesh);
-  });
-  if (any_non_guide) {
-    items.erase(std::remove_if(items.begin(), items.end(),
-                   [](MeshBuildItem const &it) { return usd_geom_mesh_is_guide_purpose(it.mesh); }),
-        items.end());
+private:
+  GfMatrix4d local_to_world(UsdPrim const &prim)
+  {
+    return xform_cache_.GetLocalToWorldTransform(prim);
   }
 
+  bool prim_might_vary(UsdPrim const &prim)
   {
-    ZoneScopedN("USD extract mesh geometry");
-    for (size_t i = 0; i < items.size(); ++i) {
-      items[i].geom_ok = extract_usd_mesh_geometry(items[i].mesh, items[i].scratch, options);
+    if (!prim || prim.IsPseudoRoot()) {
+      return false;
     }
+    auto const found = prim_varies_.find(prim.GetPath());
+    if (found != prim_varies_.end()) {
+      return found->second;
+    }
+    bool const varies =
+        xform_cache_.TransformMightBeTimeVarying(prim) || prim_might_vary(prim.GetParent());
+    prim_varies_.emplace(prim.GetPath(), varies);
+    return varies;
   }
 
-  model.meshes.resize(items.size());
+  bool instancer_might_vary(UsdStagePtr const &stage, SdfPath const &path)
   {
-    ZoneScopedN("USD finalize mesh geometry parallel");
-    tbb::parallel_for(size_t{0}, items.size(), [&](size_t i) {
-      Mesh &mesh = model.meshes[i];
-      MeshBuildItem const &item = items[i];
-      if (!item.geom_ok) {
-        mesh = Mesh{};
-        return;
+    auto const [it, inserted] = instancer_varies_.try_emplace(path, false);
+    if (inserted) {
+      UsdGeomPointInstancer const instancer(stage->GetPrimAtPath(path));
+      for (UsdAttribute const &attr : {instancer.GetProtoIndicesAttr(),
+               instancer.GetPositionsAttr(),
+               instancer.GetOrientationsAttr(),
+               instancer.GetScalesAttr()}) {
+        it->second = it->second || attr.ValueMightBeTimeVarying();
       }
-      finalize_mesh_from_scratch(
-          item.scratch, mesh, is_enabled(options, Options::LoadMeshAttributes), options);
-      mesh.name = item.name;
-      mesh.transforms = {matr4f_from_gf_matrix(item.world)};
-      mesh.material = item.material_index;
-    });
+    }
+    return it->second;
   }
 
-  model.meshes.erase(std::remove_if(model.meshes.begin(),
-                         model.meshes.end(),
-                         [](Mesh const &m) { return m.indices.empty(); }),
-      model.meshes.end());
+  size_t mesh_index(UsdPrim const &prim)
+  {
+    auto const [it, inserted] = mesh_by_path_.try_emplace(prim.GetPath(), mesh_prims_.size());
+    if (inserted) {
+      mesh_prims_.push_back(prim);
+    }
+    return it->second;
+  }
 
+  void append_point_instances(UsdGeomPointInstancer const &instancer,
+      GfMatrix4d const &root_inverse,
+      std::vector<ScenePlacement> &contents)
   {
-    ZoneScopedN("USD lights");
-    for (UsdPrim const &prim : stage->Traverse(UsdTraverseInstanceProxies())) {
-      if (prim.IsA<UsdLuxDomeLight>()) {
-        // Environment domes do not map to punctual lights; skip.
+    UsdTimeCode const time = time_;
+    SdfPathVector prototype_paths;
+    VtIntArray proto_indices;
+    VtMatrix4dArray instance_xforms;
+    if (!instancer.GetPrototypesRel().GetTargets(&prototype_paths) ||
+        !instancer.GetProtoIndicesAttr().Get(&proto_indices, time) ||
+        !instancer.ComputeInstanceTransformsAtTime(&instance_xforms, time, time)) {
+      MR_WARNING("USD: skipping point instancer {}", instancer.GetPath().GetString());
+      return;
+    }
+
+    // With the default ProtoXformInclusion, instance transforms map each prototype root's
+    // local frame (the frame collect() reports in) into the instancer's frame
+    GfMatrix4d const instancer_to_root = local_to_world(instancer.GetPrim()) * root_inverse;
+    UsdStagePtr const stage = instancer.GetPrim().GetStage();
+    std::vector<std::vector<ScenePlacement> const *> prototypes(prototype_paths.size(), nullptr);
+    for (size_t p = 0; p < prototype_paths.size(); ++p) {
+      if (UsdPrim const proto = stage->GetPrimAtPath(prototype_paths[p])) {
+        prototypes[p] = &collect(proto);
+      }
+    }
+
+    size_t const count = std::min(proto_indices.size(), instance_xforms.size());
+    for (size_t i = 0; i < count; ++i) {
+      int const p = proto_indices[i];
+      if (p < 0 || static_cast<size_t>(p) >= prototypes.size() || prototypes[p] == nullptr) {
         continue;
       }
-      if (prim.IsA<UsdLuxDistantLight>()) {
-        GfVec3f c;
-        float intensity;
-        read_usd_lux_color_and_effective_intensity(prim, c, intensity);
-        model.lights.directionals.emplace_back(c[0], c[1], c[2], intensity);
+      GfMatrix4d const instance_to_root = instance_xforms[i] * instancer_to_root;
+      for (ScenePlacement const &placement : *prototypes[p]) {
+        ScenePlacement &placed = contents.emplace_back(placement);
+        placed.to_root = placement.to_root * instance_to_root;
+        placed.instancers.push_back({instancer.GetPath(), prototype_paths[p], i});
       }
-      else if (prim.IsA<UsdLuxSphereLight>()) {
-        GfVec3f c;
-        float intensity;
-        read_usd_lux_color_and_effective_intensity(prim, c, intensity);
-        UsdLuxShapingAPI shaping(prim);
-        float cone = 180.f;
-        if (shaping.GetShapingConeAngleAttr().Get(&cone) && cone > 0.f && cone < 179.f) {
-          float const outer = GfDegreesToRadians(cone);
-          model.lights.spots.emplace_back(c[0], c[1], c[2], intensity, outer * 0.9f, outer);
+    }
+  }
+
+  MaterialResolver resolve_material_;
+  UsdTimeCode time_;
+  UsdGeomXformCache xform_cache_;
+  std::vector<UsdLight> lights_;
+  std::vector<CameraData> cameras_;
+  std::vector<UsdPrim> mesh_prims_;
+  std::unordered_map<SdfPath, size_t, SdfPath::Hash> mesh_by_path_;
+  std::unordered_map<SdfPath, std::vector<ScenePlacement>, SdfPath::Hash> contents_;
+  std::unordered_map<SdfPath, bool, SdfPath::Hash> prim_varies_;
+  std::unordered_map<SdfPath, bool, SdfPath::Hash> instancer_varies_;
+};
+
+/** Instance layout of a point instancer at one time code. */
+struct InstancerFrame {
+  VtIntArray proto_indices;
+  VtMatrix4dArray transforms;
+};
+
+static InstancerFrame sample_instancer(UsdGeomPointInstancer const &instancer, UsdTimeCode time)
+{
+  InstancerFrame frame;
+  if (!instancer.GetProtoIndicesAttr().Get(&frame.proto_indices, time) ||
+      !instancer.ComputeInstanceTransformsAtTime(&frame.transforms, time, time)) {
+    frame = InstancerFrame{};
+  }
+  return frame;
+}
+
+/**
+ * Sample the animated placements of the frame 0 walk at `times[1..]` into
+ * `MeshBuildItem::animated_transforms`. Only those placements are evaluated; one
+ * UsdGeomXformCache per worker is moved between frames with SetTime, so its attribute
+ * queries are built once. Instances of an item that never move repeat their frame 0
+ * transform. When a point instancer changes its instance layout over time the placements no
+ * longer line up with frame 0, and the affected items stay static.
+ */
+static void sample_usd_transform_animation(UsdStageRefPtr const &stage,
+    std::vector<double> const &times,
+    UsdTimeCode base_time,
+    GfMatrix4d const &upCorr,
+    std::vector<AnimatedPlacement> const &placements,
+    std::vector<MeshBuildItem> &items)
+{
+  ZoneScopedN("USD sample transform animation");
+  size_t const frames = times.size() - 1;
+
+  // Resolve prims once; paths inside instances resolve to instance proxies
+  std::vector<UsdPrim> placement_prims(placements.size());
+  std::unordered_map<SdfPath, UsdPrim, SdfPath::Hash> hop_prims;
+  std::vector<SdfPath> instancer_paths;
+  for (size_t k = 0; k < placements.size(); ++k) {
+    placement_prims[k] = stage->GetPrimAtPath(placements[k].path);
+    for (InstancerHop const &hop : placements[k].instancers) {
+      if (hop_prims.try_emplace(hop.instancer, stage->GetPrimAtPath(hop.instancer)).second) {
+        instancer_paths.push_back(hop.instancer);
+      }
+      hop_prims.try_emplace(hop.prototype, stage->GetPrimAtPath(hop.prototype));
+    }
+  }
+  std::unordered_map<SdfPath, InstancerFrame, SdfPath::Hash> base_instancers;
+  for (SdfPath const &path : instancer_paths) {
+    base_instancers.emplace(
+        path, sample_instancer(UsdGeomPointInstancer(hop_prims[path]), base_time));
+  }
+
+  // Frame-major, per animated placement
+  std::vector<AffineTransform> sampled(frames * placements.size());
+  std::vector<std::vector<size_t>> frame_broken(frames);
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, frames),
+      [&](tbb::blocked_range<size_t> const &range) {
+        UsdGeomXformCache xform_cache;
+        for (size_t f = range.begin(); f < range.end(); ++f) {
+          UsdTimeCode const time(times[f + 1]);
+          xform_cache.SetTime(time);
+
+          // Instancers whose layout differs from frame 0 keep no transforms
+          std::unordered_map<SdfPath, VtMatrix4dArray, SdfPath::Hash> instance_xforms;
+          for (SdfPath const &path : instancer_paths) {
+            InstancerFrame frame =
+                sample_instancer(UsdGeomPointInstancer(hop_prims.at(path)), time);
+            InstancerFrame const &base = base_instancers.at(path);
+            if (frame.proto_indices != base.proto_indices ||
+                frame.transforms.size() != base.transforms.size()) {
+              frame.transforms.clear();
+            }
+            instance_xforms.emplace(path, std::move(frame.transforms));
+          }
+
+          for (size_t k = 0; k < placements.size(); ++k) {
+            GfMatrix4d world = xform_cache.GetLocalToWorldTransform(placement_prims[k]);
+            bool lined_up = true;
+            for (InstancerHop const &hop : placements[k].instancers) {
+              VtMatrix4dArray const &xforms = instance_xforms.at(hop.instancer);
+              if (hop.instance >= xforms.size()) {
+                lined_up = false;
+                break;
+              }
+              // Into the prototype root's frame, then through the instance into the instancer's
+              world = world *
+                  xform_cache.GetLocalToWorldTransform(hop_prims.at(hop.prototype)).GetInverse() *
+                  xforms[hop.instance] *
+                  xform_cache.GetLocalToWorldTransform(hop_prims.at(hop.instancer));
+            }
+            if (lined_up) {
+              sampled[f * placements.size() + k] = affine_from_gf_matrix(world * upCorr);
+            }
+            else {
+              frame_broken[f].push_back(k);
+            }
+          }
         }
-        else {
-          model.lights.points.emplace_back(c[0], c[1], c[2], intensity);
+      });
+
+  std::vector<uint8_t> broken(items.size(), 0);
+  for (std::vector<size_t> const &frame : frame_broken) {
+    for (size_t k : frame) {
+      broken[placements[k].item] = 1;
+    }
+  }
+  std::vector<uint8_t> moves(items.size(), 0);
+  for (size_t f = 0; f < frames; ++f) {
+    for (size_t k = 0; k < placements.size(); ++k) {
+      AnimatedPlacement const &placement = placements[k];
+      if (!broken[placement.item] && !moves[placement.item] &&
+          sampled[f * placements.size() + k].rows !=
+              affine_from_gf_matrix(items[placement.item].worlds[placement.instance]).rows) {
+        moves[placement.item] = 1;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    MeshBuildItem &item = items[i];
+    if (broken[i]) {
+      MR_WARNING("USD: point instancer layout under {} changes over time, dropping its "
+                 "transform animation",
+          item.name);
+    }
+    else if (moves[i]) {
+      // Every frame starts as frame 0; animated instances are written over it below
+      item.animated_transforms.reserve(frames * item.worlds.size());
+      for (size_t f = 0; f < frames; ++f) {
+        for (GfMatrix4d const &world : item.worlds) {
+          item.animated_transforms.push_back(affine_from_gf_matrix(world));
         }
       }
-      else if (prim.IsA<UsdLuxDiskLight>() || prim.IsA<UsdLuxRectLight>() ||
-               prim.IsA<UsdLuxCylinderLight>()) {
-        GfVec3f c;
-        float intensity;
-        read_usd_lux_color_and_effective_intensity(prim, c, intensity);
-        model.lights.points.emplace_back(c[0], c[1], c[2], intensity);
+    }
+  }
+  for (size_t f = 0; f < frames; ++f) {
+    for (size_t k = 0; k < placements.size(); ++k) {
+      MeshBuildItem &item = items[placements[k].item];
+      if (!item.animated_transforms.empty()) {
+        item.animated_transforms[f * item.worlds.size() + placements[k].instance] =
+            sampled[f * placements.size() + k];
       }
     }
   }
+}
 
+} // namespace
+
+/**
+ * Stage and traversal results of one USD import, shared by the loader nodes. The traversal
+ * only registers materials; the materials node builds them while meshes are extracted.
+ */
+struct UsdScene {
+  UsdStageRefPtr stage;
+  std::filesystem::path stage_dir;
+  GfMatrix4d up_correction = GfMatrix4d(1.0);
+  std::vector<double> times; // Sampled frames, empty for a static import
+  UsdTimeCode base_time = UsdTimeCode::Default();
+
+  std::vector<MeshBuildItem> items;
+  /** Mesh placements of the frame 0 walk whose transforms may change, sampled per frame. */
+  std::vector<AnimatedPlacement> animated_placements;
+  /** Materials by model material index; slot 0 is the default material. */
+  std::vector<UsdShadeMaterial> materials = {UsdShadeMaterial()};
+  std::unordered_map<SdfPath, size_t, SdfPath::Hash> material_index_by_path;
+  std::mutex material_mutex;
+
+  Model::Lights lights;
+  std::vector<CameraData> cameras;
+
+  /** Model index of `material`, registered on first use. */
+  size_t material_index(UsdShadeMaterial const &material)
   {
-    ZoneScopedN("USD cameras");
-    for (UsdPrim const &prim : stage->Traverse(UsdTraverseInstanceProxies())) {
-      if (!prim.IsA<UsdGeomCamera>()) {
-        continue;
+    std::lock_guard lock(material_mutex);
+    auto const [it, inserted] =
+        material_index_by_path.try_emplace(material.GetPath(), materials.size());
+    if (inserted) {
+      materials.push_back(material);
+    }
+    return it->second;
+  }
+};
+
+namespace {
+/** Open and traverse the stage: mesh prims with placements, materials, lights and cameras. */
+static std::shared_ptr<UsdScene> open_usd_scene(
+    std::filesystem::path const &path, UsdImportFilter const &filter)
+{
+  ZoneScopedN("open_usd_scene");
+
+  std::filesystem::path const asset_path = resolve_usd_asset_path(path);
+  auto scene = std::make_shared<UsdScene>();
+  scene->stage = open_usd_stage_from_path(asset_path, filter);
+  if (!scene->stage) {
+    MR_ERROR("Failed to open USD stage: {}", asset_path.string());
+    return nullptr;
+  }
+
+  load_usd_payloads(scene->stage, filter);
+
+  scene->up_correction = stage_up_axis_correction(scene->stage);
+  scene->stage_dir = asset_path.parent_path();
+  // Frame 0 is the static import; later frames only add animation on top of it
+  scene->times = usd_sample_times(filter.time_range);
+  if (!scene->times.empty()) {
+    scene->base_time = UsdTimeCode(scene->times[0]);
+  }
+
+  {
+    ZoneScopedN("USD traverse stage");
+    // Traverse the full composed stage once. Using only UsdPrimRange(defaultPrim) omits
+    // prims outside the default prim subtree. Instances are not expanded into proxies: each
+    // prototype is read once and placed per instance.
+    UsdSceneCollector collector(
+        [scene = scene.get()](UsdShadeMaterial const &mat) { return scene->material_index(mat); },
+        scene->base_time);
+    std::vector<ScenePlacement> const &placements =
+        collector.collect(scene->stage->GetPseudoRoot());
+
+    // Bindings on an instance or its ancestors reach the prototype meshes only through the
+    // instance proxies, so every mesh placement resolves its own material in one batch
+    std::vector<UsdPrim> bound_prims;
+    for (ScenePlacement const &placement : placements) {
+      if (placement.kind == ScenePlacement::Kind::Mesh) {
+        bound_prims.push_back(scene->stage->GetPrimAtPath(placement.path));
+      }
+    }
+    std::vector<UsdShadeMaterial> const bound_materials =
+        UsdShadeMaterialBindingAPI::ComputeBoundMaterials(bound_prims);
+
+    // Items are keyed by (mesh prim, material): instances that agree on the material still
+    // share one mesh, those that differ get their own
+    std::vector<std::vector<std::pair<size_t, size_t>>> items_by_material(
+        collector.mesh_prims().size());
+    size_t bound_index = 0;
+    for (ScenePlacement const &placement : placements) {
+      // Row-vector USD: p_w = p_l * W, then stage up-axis p' = p_w * U, so p' = p_l * (W * U).
+      GfMatrix4d const world = placement.to_root * scene->up_correction;
+      switch (placement.kind) {
+      case ScenePlacement::Kind::Mesh: {
+        UsdShadeMaterial material = bound_materials[bound_index++];
+        if (material.GetPrim().IsInstanceProxy()) {
+          // Materials inside an instance are registered once, under their prototype path
+          material = UsdShadeMaterial(material.GetPrim().GetPrimInPrototype());
+        }
+        size_t const material_index =
+            material.GetPrim().IsValid() ? scene->material_index(material) : 0;
+        std::vector<std::pair<size_t, size_t>> &mesh_items = items_by_material[placement.index];
+        auto found = std::find_if(mesh_items.begin(), mesh_items.end(), [&](auto const &entry) {
+          return entry.first == material_index;
+        });
+        if (found == mesh_items.end()) {
+          UsdPrim const &prim = collector.mesh_prims()[placement.index];
+          MeshBuildItem item;
+          item.mesh = UsdGeomMesh(prim);
+          item.name = prim.GetName();
+          item.material_index = material_index;
+          scene->items.push_back(std::move(item));
+          found = mesh_items.emplace(mesh_items.end(), material_index, scene->items.size() - 1);
+        }
+        std::vector<GfMatrix4d> &worlds = scene->items[found->second].worlds;
+        if (scene->times.size() > 1 && collector.might_vary(scene->stage, placement)) {
+          scene->animated_placements.push_back(
+              {found->second, worlds.size(), placement.path, placement.instancers});
+        }
+        worlds.push_back(world);
+        break;
+      }
+      case ScenePlacement::Kind::Light:
+        append_usd_light(scene->lights, collector.lights()[placement.index]);
+        break;
+      case ScenePlacement::Kind::Camera: {
+        CameraData cd = collector.cameras()[placement.index];
+        cd.world_from_camera = matr4f_from_gf_matrix(world);
+        scene->cameras.push_back(std::move(cd));
+        break;
       }
-      UsdGeomCamera cam(prim);
-      CameraData cd{};
-      cd.name = prim.GetName();
-      UsdGeomXformable xf(prim);
-      GfMatrix4d w = xf.ComputeLocalToWorldTransform(UsdTimeCode::Default());
-      w = w * upCorr;
-      cd.world_from_camera = matr4f_from_gf_matrix(w);
-      TfToken proj;
-      if (cam.GetProjectionAttr().Get(&proj)) {
-        cd.perspective = (proj == UsdGeomTokens->perspective);
       }
-      cam.GetFocalLengthAttr().Get(&cd.focal_length_mm);
-      cam.GetHorizontalApertureAttr().Get(&cd.horizontal_aperture_mm);
-      cam.GetVerticalApertureAttr().Get(&cd.vertical_aperture_mm);
-      GfVec2f cr(0.01f, 1e6f);
-      if (cam.GetClippingRangeAttr().Get(&cr)) {
-        cd.clipping_range_near = cr[0];
-        cd.clipping_range_far = cr[1];
+    }
+  }
+  return scene;
+}
+
+static std::vector<MaterialData> load_usd_materials(UsdScene const &scene, Options options)
+{
+  ZoneScopedN("load_usd_materials");
+
+  // Materials are independent, so texture decodes of different materials overlap
+  std::vector<MaterialData> materials(scene.materials.size());
+  tbb::parallel_for(size_t{0}, materials.size(), [&](size_t i) {
+    MaterialData &md = materials[i];
+    if (i == 0) {
+      md.constants.base_color_factor = Color(1, 1, 1, 1);
+      return;
+    }
+    md.constants.base_color_factor = Color(0.8f, 0.8f, 0.8f, 1.f);
+    if (is_enabled(options, Options::LoadMaterials)) {
+      if (auto preview = find_preview_surface(scene.materials[i])) {
+        md = build_material_from_preview(*preview, scene.stage_dir, options);
       }
-      model.cameras.push_back(std::move(cd));
     }
+  });
+  return materials;
+}
+
+static std::vector<Mesh> load_usd_meshes(UsdScene &scene, Options options)
+{
+  ZoneScopedN("load_usd_meshes");
+
+  std::vector<MeshBuildItem> &items = scene.items;
+  std::vector<double> const &times = scene.times;
+  if (!scene.animated_placements.empty()) {
+    sample_usd_transform_animation(scene.stage,
+        times,
+        scene.base_time,
+        scene.up_correction,
+        scene.animated_placements,
+        items);
   }
 
-  return true;
+  bool const any_non_guide = std::any_of(items.begin(), items.end(), [](MeshBuildItem const &it) {
+    return !usd_geom_mesh_is_guide_purpose(it.mesh);
+  });
+  if (any_non_guide) {
+    items.erase(std::remove_if(items.begin(), items.end(),
+                   [](MeshBuildItem const &it) { return usd_geom_mesh_is_guide_purpose(it.mesh); }),
+        items.end());
+  }
+
+  {
+    ZoneScopedN("USD extract mesh geometry parallel");
+    // Reads from a loaded stage are thread-safe. A prim's size is unknown until its arrays are
+    // read, so every prim is its own task and work stealing keeps the threads busy.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, items.size(), 1),
+        [&](tbb::blocked_range<size_t> const &range) {
+          for (size_t i = range.begin(); i < range.end(); ++i) {
+            items[i].geom_ok =
+                extract_usd_mesh_geometry(items[i].mesh, scene.base_time, items[i].arrays, options);
+          }
+        },
+        tbb::simple_partitioner());
+  }
+
+  // Finalize heaviest prims first so one large mesh does not start last and serialize the tail
+  std::vector<size_t> order(items.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return items[lhs].arrays.face_vertex_indices.size() >
+           items[rhs].arrays.face_vertex_indices.size();
+  });
+
+  std::vector<Mesh> meshes(items.size());
+  {
+    ZoneScopedN("USD finalize mesh geometry parallel");
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, order.size(), 1),
+        [&](tbb::blocked_range<size_t> const &range) {
+          for (size_t k = range.begin(); k < range.end(); ++k) {
+            size_t const i = order[k];
+            Mesh &mesh = meshes[i];
+            MeshBuildItem &item = items[i];
+            if (!item.geom_ok) {
+              mesh = Mesh{};
+              continue;
+            }
+            std::vector<uint32_t> vertex_points;
+            build_mesh_from_usd_arrays(item.arrays,
+                mesh,
+                is_enabled(options, Options::LoadMeshAttributes),
+                options,
+                vertex_points);
+            if (!mesh.indices.empty()) {
+              sample_usd_point_animation(
+                  item.mesh, times, item.arrays.points, vertex_points, mesh);
+            }
+            item.arrays = UsdMeshArrays{};
+            mesh.name = item.name;
+            TransformArray::Table transforms;
+            transforms.reserve(item.worlds.size());
+            for (GfMatrix4d const &world : item.worlds) {
+              transforms.push_back(affine_from_gf_matrix(world));
+            }
+            mesh.transforms = TransformArray(std::move(transforms));
+            if (!item.animated_transforms.empty()) {
+              std::span<AffineTransform const> const first_frame = mesh.transforms.affine();
+              mesh.animation.transforms.reserve(
+                  first_frame.size() + item.animated_transforms.size());
+              mesh.animation.transforms.assign(first_frame.begin(), first_frame.end());
+              mesh.animation.transforms.insert(mesh.animation.transforms.end(),
+                  item.animated_transforms.begin(),
+                  item.animated_transforms.end());
+              item.animated_transforms = {};
+            }
+            if (!mesh.animation.position_deltas.empty() || !mesh.animation.transforms.empty()) {
+              mesh.animation.times = times;
+            }
+            mesh.material = item.material_index;
+          }
+        },
+        tbb::simple_partitioner());
+  }
+
+  meshes.erase(std::remove_if(meshes.begin(),
+                   meshes.end(),
+                   [](Mesh const &m) { return m.indices.empty(); }),
+      meshes.end());
+  return meshes;
 }
 
+/**
+ * Drop the graph's reference to the opened scene once the last loader node is done with it,
+ * so the composed stage is freed while meshes are still optimized, not at the end of import.
+ * The token pointer stays a non-null marker downstream and is not dereferenced there.
+ */
+static void release_usd_scene(FlowGraph &graph)
+{
+  if (--graph.usd_scene_users == 0) {
+    ZoneScopedN("release_usd_scene");
+    graph.usd_scene.reset();
+  }
+}
 } // namespace
 
 void add_usd_loader_nodes(FlowGraph &graph, const Options &options)
@@ -768,31 +1759,57 @@ void add_usd_loader_nodes(FlowGraph &graph, const Options &options)
   ZoneScoped;
 
   graph.asset_loader = std::make_unique<tbb::flow::input_node<void *>>(
-      graph.graph, [&graph, &options](oneapi::tbb::flow_control &fc) -> void * {
+      graph.graph, [&graph](oneapi::tbb::flow_control &fc) -> void * {
         if (graph.model) {
           fc.stop();
           return nullptr;
         }
 
         ZoneScoped;
-        graph.model = std::make_unique<Model>();
-        if (!load_usd_into_model(*graph.model, graph.path, options)) {
-          graph.model.reset();
+        graph.usd_scene = open_usd_scene(graph.path, graph.usd_filter);
+        if (!graph.usd_scene) {
           fc.stop();
           return nullptr;
         }
 
-        return usd_pipeline_token();
+        graph.model = std::make_unique<Model>();
+
+        // Meshes, materials and lights each read the scene
+        graph.usd_scene_users = 3;
+        return static_cast<void *>(graph.usd_scene.get());
       });
 
-  graph.meshes_load = std::make_unique<tbb::flow::function_node<void *, void *>>(
-      graph.graph, tbb::flow::unlimited, [](void *token) -> void * { return token; });
+  graph.meshes_load =
+      std::make_unique<tbb::flow::function_node<void *, void *>>(graph.graph,
+          tbb::flow::unlimited,
+          [&graph, &options](void *token) -> void * {
+            if (token != nullptr) {
+              ZoneScoped;
+              graph.model->meshes = load_usd_meshes(*static_cast<UsdScene *>(token), options);
+              release_usd_scene(graph);
+            }
+            return token;
+          });
 
   graph.materials_load = std::make_unique<tbb::flow::function_node<void *>>(
-      graph.graph, tbb::flow::unlimited, [](void *) {});
+      graph.graph, tbb::flow::unlimited, [&graph, &options](void *token) {
+        if (token != nullptr) {
+          ZoneScoped;
+          graph.model->materials = load_usd_materials(*static_cast<UsdScene *>(token), options);
+          release_usd_scene(graph);
+        }
+      });
 
-  graph.lights_load =
-      std::make_unique<tbb::flow::function_node<void *>>(graph.graph, tbb::flow::unlimited, [](void *) {});
+  graph.lights_load = std::make_unique<tbb::flow::function_node<void *>>(
+      graph.graph, tbb::flow::unlimited, [&graph](void *token) {
+        if (token != nullptr) {
+          ZoneScoped;
+          UsdScene &scene = *static_cast<UsdScene *>(token);
+          graph.model->lights = std::move(scene.lights);
+          graph.model->cameras = std::move(scene.cameras);
+          release_usd_scene(graph);
+        }
+      });
 
   tbb::flow::make_edge(*graph.asset_loader, *graph.meshes_load);
   tbb::flow::make_edge(*graph.asset_loader, *graph.materials_load);
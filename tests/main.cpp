@@ -1,10 +1,116 @@
 #include <gtest/gtest.h>
 #include <mr-importer/importer.hpp>
+#include <mr-importer/optimizer.hpp>
 
+#include "accessors.hpp"
+#include "image_decoder.hpp"
+#include "pixels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <tbb/task_arena.h>
 
 namespace fs = std::filesystem;
 
+namespace {
+std::vector<std::byte> read_test_file(fs::path const &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::vector<char> const bytes {std::istreambuf_iterator<char>(file), {}};
+  std::vector<std::byte> result(bytes.size());
+  std::memcpy(result.data(), bytes.data(), bytes.size());
+  return result;
+}
+
+// One pixel at a time: copy what the source has, zero new components, opaque alpha
+std::vector<std::byte> expand_channels_reference(
+    std::vector<std::byte> const &src, size_t pixel_count, mr::ChannelExpansion expansion)
+{
+  std::vector<std::byte> dst(pixel_count * expansion.dst_pixel_size());
+  for (size_t i = 0; i < pixel_count; i++) {
+    for (uint32_t byte = 0; byte < expansion.dst_pixel_size(); byte++) {
+      std::byte &out = dst[i * expansion.dst_pixel_size() + byte];
+      if (byte < expansion.src_pixel_size()) {
+        out = src[i * expansion.src_pixel_size() + byte];
+      }
+      else {
+        out = byte / expansion.component_size == 3 ? std::byte(0xFF) : std::byte(0x00);
+      }
+    }
+  }
+  return dst;
+}
+
+// Four scalars 0, 1, 2, 3 of type `T` with one sparse substitution of `sparse_index` by `value`
+template <typename T>
+fastgltf::Asset make_sparse_asset(
+    fastgltf::ComponentType component_type, bool normalized, uint16_t sparse_index, T value)
+{
+  std::vector<std::byte> bytes(4 * sizeof(T) + 2 * sizeof(uint16_t) + sizeof(T));
+  for (uint32_t i = 0; i < 4; i++) {
+    T const base = T(i);
+    std::memcpy(bytes.data() + i * sizeof(T), &base, sizeof(T));
+  }
+  std::memcpy(bytes.data() + 4 * sizeof(T), &sparse_index, sizeof(sparse_index));
+  std::memcpy(bytes.data() + 4 * sizeof(T) + 2 * sizeof(uint16_t), &value, sizeof(T));
+
+  fastgltf::Asset asset;
+  fastgltf::Buffer &buffer = asset.buffers.emplace_back();
+  buffer.byteLength = bytes.size();
+  buffer.data = fastgltf::sources::Vector {std::move(bytes), fastgltf::MimeType::None};
+
+  // Base values, sparse index (padded to 4 bytes), sparse value
+  size_t const view_offsets[] = {0, 4 * sizeof(T), 4 * sizeof(T) + 2 * sizeof(uint16_t)};
+  size_t const view_lengths[] = {4 * sizeof(T), sizeof(uint16_t), sizeof(T)};
+  for (uint32_t i = 0; i < 3; i++) {
+    fastgltf::BufferView &view = asset.bufferViews.emplace_back();
+    view.bufferIndex = 0;
+    view.byteOffset = view_offsets[i];
+    view.byteLength = view_lengths[i];
+  }
+
+  fastgltf::Accessor &accessor = asset.accessors.emplace_back();
+  accessor.byteOffset = 0;
+  accessor.count = 4;
+  accessor.type = fastgltf::AccessorType::Scalar;
+  accessor.componentType = component_type;
+  accessor.normalized = normalized;
+  accessor.bufferViewIndex = 0;
+
+  fastgltf::SparseAccessor sparse {};
+  sparse.count = 1;
+  sparse.indicesBufferView = 1;
+  sparse.indicesByteOffset = 0;
+  sparse.valuesBufferView = 2;
+  sparse.valuesByteOffset = 0;
+  sparse.indexComponentType = fastgltf::ComponentType::UnsignedShort;
+  accessor.sparse = sparse;
+  return asset;
+}
+
+// One triangle whose second vertex sits at x = 1 + `stretch`, placed at x = `translation`
+mr::Mesh make_triangle_mesh(size_t material, float stretch, float translation)
+{
+  mr::Mesh mesh;
+  mesh.positions = mr::PositionArray {{0, 0, 0}, {1 + stretch, 0, 0}, {0, 1, 0}};
+  mesh.indices = mr::IndexArray {0, 1, 2};
+  mesh.material = material;
+
+  mr::AffineTransform transform;
+  transform.rows = {{{1, 0, 0, translation}, {0, 1, 0, 0}, {0, 0, 1, 0}}};
+  mesh.transforms = mr::TransformArray::Table {transform};
+  return mesh;
+}
+} // namespace
+
 TEST(UsdImport, TriangleMesh)
 {
   fs::path const usd = fs::path(__FILE__).parent_path() / "data" / "triangle.usda";
@@ -14,3 +120,188 @@ TEST(UsdImport, TriangleMesh)
   EXPECT_GE(model->meshes.front().indices.size(), 3u);
   EXPECT_FALSE(model->materials.empty());
 }
+
+TEST(UsdImport, ConcaveFace)
+{
+  // L-shaped hexagon of area 3 whose first corner is next to the reflex one, so a fan from
+  // it would fold a triangle over the outside of the face
+  fs::path const usd = fs::path(__FILE__).parent_path() / "data" / "lshape.usda";
+  auto model = mr::importer::import(usd, mr::importer::Options::None);
+  ASSERT_TRUE(model.has_value());
+  ASSERT_EQ(model->meshes.size(), 1u);
+
+  mr::Mesh const &mesh = model->meshes.front();
+  ASSERT_EQ(mesh.indices.size(), 12u);
+
+  // Triangles that don't overlap all wind the same way and their areas add up to the face
+  auto normal = [&](size_t t) {
+    mr::Position const &a = mesh.positions[mesh.indices[t * 3]];
+    mr::Position const &b = mesh.positions[mesh.indices[t * 3 + 1]];
+    mr::Position const &c = mesh.positions[mesh.indices[t * 3 + 2]];
+    float const u[3] {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float const v[3] {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    return std::array<float, 3> {
+        u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+  };
+
+  std::array<float, 3> const first = normal(0);
+  float area = 0;
+  for (size_t t = 0; t < 4; t++) {
+    std::array<float, 3> const n = normal(t);
+    EXPECT_GT(n[0] * first[0] + n[1] * first[1] + n[2] * first[2], 0) << "triangle " << t;
+    area += std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) / 2;
+  }
+  EXPECT_NEAR(area, 3.0f, 1e-5f);
+}
+
+TEST(GltfImport, PartiallyQuantizedPrimitive)
+{
+  // uint16 positions and normalized int8 normals (KHR_mesh_quantization), float texcoords
+  fs::path const gltf = fs::path(__FILE__).parent_path() / "data" / "quantized.gltf";
+  mr::Options options = mr::Options::LoadMeshAttributes;
+  mr::enable(options, mr::Options::KeepQuantizedVertices);
+  auto model = mr::importer::import(gltf, options);
+  ASSERT_TRUE(model.has_value());
+  ASSERT_EQ(model->meshes.size(), 1u);
+
+  mr::Mesh const &mesh = model->meshes.front();
+  ASSERT_EQ(mesh.quantized.positions.size(), 3u);
+  ASSERT_EQ(mesh.quantized.normals.size(), 3u);
+  EXPECT_TRUE(mesh.quantized.texcoords.empty());
+  EXPECT_NEAR(mesh.quantized.normal_decode(mesh.quantized.normals[0][2]), 1.0f, 1e-6f);
+
+  // Only the texcoords went to the float attributes, the normal slots there are not data
+  ASSERT_EQ(mesh.attributes.size(), 3u);
+  EXPECT_FALSE(mesh.attributes.is_normal_present);
+  EXPECT_TRUE(mesh.attributes.is_texcoord_present);
+  EXPECT_EQ(mesh.attributes[1].texcoord.x(), 1.0f);
+  EXPECT_EQ(mesh.attributes[2].texcoord.y(), 1.0f);
+}
+
+TEST(Pixels, ExpandChannelsMatchesScalar)
+{
+  std::mt19937 rng(0x5eed);
+  // Counts below one vector group, with ragged tails, and across a parallel chunk boundary
+  size_t const pixel_counts[] = {0, 1, 3, 4, 5, 15, 16, 17, 255, 1000, (1 << 16) + 7};
+
+  for (uint32_t component_size : {1u, 2u, 4u}) {
+    for (uint32_t src_components = 1; src_components <= 4; src_components++) {
+      for (uint32_t dst_components = src_components; dst_components <= 4; dst_components++) {
+        mr::ChannelExpansion const expansion {src_components, dst_components, component_size};
+        for (size_t pixel_count : pixel_counts) {
+          SCOPED_TRACE(testing::Message()
+                       << src_components << " -> " << dst_components << " components of "
+                       << component_size << " bytes, " << pixel_count << " pixels");
+
+          std::vector<std::byte> src(pixel_count * expansion.src_pixel_size());
+          for (std::byte &b : src) {
+            b = std::byte(rng());
+          }
+          std::vector<std::byte> const expected =
+              expand_channels_reference(src, pixel_count, expansion);
+
+          std::vector<std::byte> dst(expected.size(), std::byte(0xCD));
+          mr::expand_channels(src.data(), dst.data(), pixel_count, expansion);
+          EXPECT_EQ(dst, expected);
+
+          std::vector<std::byte> in_place(expected.size(), std::byte(0xCD));
+          std::copy(src.begin(), src.end(), in_place.begin());
+          mr::expand_channels_in_place(in_place.data(), pixel_count, expansion);
+          EXPECT_EQ(in_place, expected);
+        }
+      }
+    }
+  }
+}
+
+TEST(ImageDecoder, BandedJpegMatchesSinglePass)
+{
+  // 2048x2048 4:2:0 baseline JPEG with a restart marker after every MCU row
+  fs::path const jpeg = fs::path(__FILE__).parent_path() / "data" / "restart_420.jpg";
+  std::vector<std::byte> const data = read_test_file(jpeg);
+  ASSERT_FALSE(data.empty());
+  if (tbb::this_task_arena::max_concurrency() < 2) {
+    GTEST_SKIP() << "Banded decode needs more than one thread";
+  }
+
+  mr::ImageData banded;
+  ASSERT_TRUE(mr::decode_wuffs_image(data, mr::Options::All, banded));
+
+  // A one-thread arena plans a single band, which is the plain wuffs decode
+  mr::ImageData single;
+  tbb::task_arena serial(1);
+  ASSERT_TRUE(serial.execute(
+      [&] { return mr::decode_wuffs_image(data, mr::Options::All, single); }));
+
+  ASSERT_EQ(banded.width, single.width);
+  ASSERT_EQ(banded.height, single.height);
+  ASSERT_EQ(banded.format, single.format);
+  ASSERT_EQ(banded.pixels.size(), single.pixels.size());
+  EXPECT_EQ(std::memcmp(banded.pixels.get(), single.pixels.get(), single.pixels.size()), 0);
+}
+
+TEST(Accessors, SparseSubstitution)
+{
+  fastgltf::Asset const asset =
+      make_sparse_asset<float>(fastgltf::ComponentType::Float, false, 2, 10.0f);
+  std::vector<float> values(4, -1.0f);
+  ASSERT_TRUE(mr::convert_accessor(
+      asset, asset.accessors[0], 1, reinterpret_cast<std::byte *>(values.data()), sizeof(float)));
+  EXPECT_EQ(values, (std::vector<float> {0.0f, 1.0f, 10.0f, 3.0f}));
+
+  fastgltf::Asset const quantized =
+      make_sparse_asset<uint16_t>(fastgltf::ComponentType::UnsignedShort, true, 2, 65535);
+  std::vector<uint16_t> stored(4, 0xCDCD);
+  ASSERT_TRUE(mr::copy_quantized_accessor(quantized,
+      quantized.accessors[0],
+      1,
+      reinterpret_cast<std::byte *>(stored.data()),
+      sizeof(uint16_t)));
+  EXPECT_EQ(stored, (std::vector<uint16_t> {0, 1, 65535, 3}));
+}
+
+TEST(Accessors, SparseIndexOutOfRange)
+{
+  // Index 4 is one past the last element of the accessor
+  fastgltf::Asset const asset =
+      make_sparse_asset<float>(fastgltf::ComponentType::Float, false, 4, 10.0f);
+  std::vector<float> values(5, -1.0f);
+  EXPECT_FALSE(mr::convert_accessor(
+      asset, asset.accessors[0], 1, reinterpret_cast<std::byte *>(values.data()), sizeof(float)));
+  EXPECT_EQ(values[4], -1.0f);
+
+  fastgltf::Asset const quantized =
+      make_sparse_asset<uint16_t>(fastgltf::ComponentType::UnsignedShort, true, 4, 65535);
+  std::vector<uint16_t> stored(5, 0xCDCD);
+  EXPECT_FALSE(mr::copy_quantized_accessor(quantized,
+      quantized.accessors[0],
+      1,
+      reinterpret_cast<std::byte *>(stored.data()),
+      sizeof(uint16_t)));
+  EXPECT_EQ(stored[4], 0xCDCD);
+}
+
+TEST(Optimizer, DeduplicateMeshes)
+{
+  std::vector<mr::Mesh> meshes;
+  meshes.emplace_back(make_triangle_mesh(0, 0, 1));
+  meshes.emplace_back(make_triangle_mesh(1, 0, 2)); // Other material
+  meshes.emplace_back(make_triangle_mesh(0, 0, 3)); // Duplicate of the first one
+  meshes.emplace_back(make_triangle_mesh(0, 0.5f, 4)); // Other positions
+
+  std::vector<mr::Mesh> const unique = mr::deduplicate_meshes(std::move(meshes));
+  ASSERT_EQ(unique.size(), 3u);
+
+  // The duplicate folds into the first mesh, which keeps both placements in input order
+  ASSERT_EQ(unique[0].transforms.size(), 2u);
+  EXPECT_EQ(unique[0].transforms.affine()[0].rows[0][3], 1);
+  EXPECT_EQ(unique[0].transforms.affine()[1].rows[0][3], 3);
+
+  EXPECT_EQ(unique[1].material, 1u);
+  ASSERT_EQ(unique[1].transforms.size(), 1u);
+  EXPECT_EQ(unique[1].transforms.affine()[0].rows[0][3], 2);
+
+  EXPECT_EQ(unique[2].positions[1][0], 1.5f);
+  ASSERT_EQ(unique[2].transforms.size(), 1u);
+  EXPECT_EQ(unique[2].transforms.affine()[0].rows[0][3], 4);
+}